@@ -58,7 +58,7 @@ public:
     void Stop() override { running_ = false; }
     bool IsRunning() const override { return running_; }
 
-    void OnFrame(std::shared_ptr<Frame> frame) override
+    void OnFrame(const std::shared_ptr<Frame> &frame) override
     {
         if (!running_)
             return;
@@ -123,7 +123,7 @@ private:
         }
     }
 
-    void SaveFrameToFile(std::shared_ptr<Frame> frame)
+    void SaveFrameToFile(const std::shared_ptr<Frame> &frame)
     {
         // Save as Y4M format for video playback
         SaveAsY4M(frame);
@@ -134,7 +134,7 @@ private:
         }
     }
 
-    void SaveAsY4M(std::shared_ptr<Frame> frame)
+    void SaveAsY4M(const std::shared_ptr<Frame> &frame)
     {
         static bool y4m_header_written = false;
         std::string y4m_filename = output_prefix_ + ".y4m";
@@ -166,7 +166,7 @@ private:
         file.close();
     }
 
-    void SaveAsRawYUV420(std::shared_ptr<Frame> frame)
+    void SaveAsRawYUV420(const std::shared_ptr<Frame> &frame)
     {
         std::stringstream ss;
         ss << output_prefix_ << "_frame_" << std::setfill('0') << std::setw(6) << frame_count_ << ".yuv";
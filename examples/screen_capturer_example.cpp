@@ -41,7 +41,7 @@ public:
         start_time_ = std::chrono::steady_clock::now();
     }
 
-    void OnFrame(std::shared_ptr<Frame> frame) override
+    void OnFrame(const std::shared_ptr<Frame> &frame) override
     {
         frame_count_++;
         total_bytes_ += frame->Size();
@@ -85,7 +85,7 @@ public:
     }
 
 private:
-    void SaveFrameToFile(std::shared_ptr<Frame> frame)
+    void SaveFrameToFile(const std::shared_ptr<Frame> &frame)
     {
         // Save as Y4M format for video playback compatibility
         SaveAsY4M(frame);
@@ -94,7 +94,7 @@ private:
         SaveAsRawRGB(frame);
     }
 
-    void SaveAsY4M(std::shared_ptr<Frame> frame)
+    void SaveAsY4M(const std::shared_ptr<Frame> &frame)
     {
         static bool y4m_header_written = false;
         std::string y4m_filename = output_prefix_ + ".y4m";
@@ -121,7 +121,7 @@ private:
         file.close();
     }
 
-    void SaveAsRawRGB(std::shared_ptr<Frame> frame)
+    void SaveAsRawRGB(const std::shared_ptr<Frame> &frame)
     {
         std::stringstream ss;
 
@@ -146,7 +146,7 @@ private:
         }
     }
 
-    void ConvertRGBToYUV444AndWrite(std::shared_ptr<Frame> frame, std::ofstream &file)
+    void ConvertRGBToYUV444AndWrite(const std::shared_ptr<Frame> &frame, std::ofstream &file)
     {
         const uint8_t *rgb_data = frame->Data();
         int width = frame->video_info.width;
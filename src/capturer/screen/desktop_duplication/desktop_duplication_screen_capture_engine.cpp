@@ -14,6 +14,7 @@
 #include <iostream>
 #include <thread>
 
+#include "../../../core/frame_tracer.h"
 #include "../../../log/remote_desk_log.h"
 
 namespace lmshao::remotedesk {
@@ -81,6 +82,7 @@ CaptureResult DesktopDuplicationScreenCaptureEngine::Start()
     LOG_DEBUG("Starting Desktop Duplication screen capture");
 
     should_stop_ = false;
+    heartbeat_ = StageWatchdog::GetInstance()->RegisterStage("capture", config_.display_name, StageKind::LOOP);
     capture_thread_ = std::make_unique<std::thread>(&DesktopDuplicationScreenCaptureEngine::CaptureThreadProc, this);
     is_running_ = true;
 
@@ -103,6 +105,7 @@ void DesktopDuplicationScreenCaptureEngine::Stop()
         capture_thread_->join();
     }
     capture_thread_.reset();
+    heartbeat_.reset();
     is_running_ = false;
 
     LOG_DEBUG("Desktop Duplication screen capture stopped");
@@ -156,7 +159,7 @@ std::vector<ScreenInfo> DesktopDuplicationScreenCaptureEngine::GetAvailableScree
     return screens;
 }
 
-void DesktopDuplicationScreenCaptureEngine::SetFrameCallback(std::function<void(std::shared_ptr<Frame>)> callback)
+void DesktopDuplicationScreenCaptureEngine::SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     frame_callback_ = callback;
@@ -276,9 +279,11 @@ CaptureResult DesktopDuplicationScreenCaptureEngine::InitializeDesktopDuplicatio
 
 void DesktopDuplicationScreenCaptureEngine::CaptureThreadProc()
 {
+    ApplyThreadScheduling(config_.thread_scheduling, "Desktop Duplication capture");
     last_frame_time_ = std::chrono::steady_clock::now();
 
     while (!should_stop_) {
+        heartbeat_->Beat();
         auto now = std::chrono::steady_clock::now();
         auto elapsed = now - last_frame_time_;
 
@@ -332,7 +337,12 @@ CaptureResult DesktopDuplicationScreenCaptureEngine::CaptureFrame()
     }
 
     // Convert surface to frame
+    int64_t capture_begin_ns = FrameTracer::Now();
     auto frame = ConvertSurfaceToFrame(surface);
+    if (frame) {
+        FrameTracer::Record("surface copy", TraceCategory::CAPTURE, frame->timestamp, capture_begin_ns,
+                            FrameTracer::Now());
+    }
     if (frame && frame_callback_) {
         frame_callback_(frame);
     } else if (!frame) {
@@ -459,7 +469,7 @@ CaptureResult DesktopDuplicationScreenCaptureEngine::HResultToCaptureResult(HRES
     }
 }
 
-void DesktopDuplicationScreenCaptureEngine::CaptureCursor(std::shared_ptr<Frame> frame)
+void DesktopDuplicationScreenCaptureEngine::CaptureCursor(const std::shared_ptr<Frame> &frame)
 {
     // TODO: Implement cursor capture using GetCursorInfo and overlaying on frame
     // This would require additional Win32 API calls and image composition
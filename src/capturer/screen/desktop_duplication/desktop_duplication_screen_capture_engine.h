@@ -25,6 +25,7 @@
 #include <thread>
 #include <vector>
 
+#include "../../../core/stage_watchdog.h"
 #include "../iscreen_capture_engine.h"
 
 namespace lmshao::remotedesk {
@@ -47,7 +48,7 @@ public:
     void Stop() override;
     bool IsRunning() const override;
     std::vector<ScreenInfo> GetAvailableScreens() const override;
-    void SetFrameCallback(std::function<void(std::shared_ptr<Frame>)> callback) override;
+    void SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback) override;
     const ScreenCaptureConfig &GetConfig() const override;
     CaptureResult UpdateConfig(const ScreenCaptureConfig &config) override;
 
@@ -86,7 +87,7 @@ private:
      * @brief Capture cursor if enabled
      * @param frame Frame to overlay cursor on
      */
-    void CaptureCursor(std::shared_ptr<Frame> frame);
+    void CaptureCursor(const std::shared_ptr<Frame> &frame);
 
     /**
      * @brief Cleanup D3D and DXGI resources
@@ -123,6 +124,7 @@ private:
     // Capture thread
     std::unique_ptr<std::thread> capture_thread_;
     std::atomic<bool> should_stop_{false};
+    std::shared_ptr<StageHeartbeat> heartbeat_; // Capture loop progress, watched by StageWatchdog
     mutable std::mutex mutex_;
 
     // Frame timing
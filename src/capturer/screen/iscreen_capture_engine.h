@@ -59,7 +59,7 @@ public:
      * @brief Set frame callback function
      * @param callback Function to be called when a new frame is captured
      */
-    virtual void SetFrameCallback(std::function<void(std::shared_ptr<Frame>)> callback) = 0;
+    virtual void SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback) = 0;
 
     /**
      * @brief Get current capture configuration
@@ -83,7 +83,7 @@ protected:
     /**
      * @brief Frame callback function
      */
-    std::function<void(std::shared_ptr<Frame>)> frame_callback_;
+    std::function<void(const std::shared_ptr<Frame> &)> frame_callback_;
 
     /**
      * @brief Last error message
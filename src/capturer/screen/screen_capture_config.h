@@ -12,6 +12,8 @@
 #include <cstdint>
 #include <string>
 
+#include "../../core/thread_scheduling.h"
+
 namespace lmshao::remotedesk {
 
 /**
@@ -62,6 +64,26 @@ struct ScreenCaptureConfig {
      * @brief Pixel format preference (platform-specific)
      */
     std::string pixel_format = "BGRA";
+
+    /**
+     * @brief X display to capture, e.g. ":12" (empty = $DISPLAY)
+     */
+    std::string display_name;
+
+    /**
+     * @brief Xvfb -fbdir directory for the Xvfb framebuffer engine (empty = $XVFB_FBDIR)
+     */
+    std::string framebuffer_dir;
+
+    /**
+     * @brief Scheduling of the capture thread, e.g. SCHED_FIFO pinned to a reserved core
+     */
+    ThreadSchedulingConfig thread_scheduling;
+
+    /**
+     * @brief Lock the captured memory in RAM (the Xvfb framebuffer mapping)
+     */
+    bool lock_memory = false;
 };
 
 /**
@@ -17,7 +17,10 @@
 #endif
 
 #ifdef __linux__
+#include <unistd.h>
+
 #include "x11/x11_screen_capture_engine.h"
+#include "xvfb/xvfb_framebuffer_capture_engine.h"
 // #include "wayland/wayland_tool_engine.h"  // Not implemented yet
 #endif
 
@@ -27,13 +30,14 @@
 
 namespace lmshao::remotedesk {
 
-std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateEngine(Technology technology)
+std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateEngine(Technology technology,
+                                                                              const ScreenCaptureConfig &config)
 {
     Technology target_technology = technology;
 
     // Auto-detect best available technology if requested
     if (technology == Technology::Auto) {
-        target_technology = GetBestAvailableTechnology();
+        target_technology = GetBestAvailableTechnology(config);
     }
 
     // Check if the technology is supported
@@ -49,6 +53,9 @@ std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateEngine(T
         case Technology::X11:
             return CreateX11Engine();
 
+        case Technology::XvfbFramebuffer:
+            return CreateXvfbFramebufferEngine();
+
         case Technology::WaylandTool:
             return CreateWaylandToolEngine();
 
@@ -60,9 +67,11 @@ std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateEngine(T
     }
 }
 
-ScreenCaptureEngineFactory::Technology ScreenCaptureEngineFactory::GetBestAvailableTechnology()
+ScreenCaptureEngineFactory::Technology ScreenCaptureEngineFactory::GetBestAvailableTechnology(
+    const ScreenCaptureConfig &config)
 {
 #ifdef _WIN32
+    (void)config;
     return Technology::DesktopDuplication;
 #elif defined(__linux__)
     // Environment detection logic
@@ -70,8 +79,11 @@ ScreenCaptureEngineFactory::Technology ScreenCaptureEngineFactory::GetBestAvaila
     const char *x11_display = std::getenv("DISPLAY");
     // bool wayland_tool_available = WaylandToolEngine::IsAvailable();  // Not implemented yet
 
-    // Priority: X11 for now
-    if (x11_display) {
+    // Priority: Xvfb framebuffer when the captured display exports one, then X11
+    std::string framebuffer = XvfbFramebufferCaptureEngine::GetFramebufferPath(config, config.monitor_index);
+    if (!framebuffer.empty() && access(framebuffer.c_str(), R_OK) == 0) {
+        return Technology::XvfbFramebuffer;
+    } else if (x11_display || !config.display_name.empty()) {
         return Technology::X11;
     } else if (wayland_display) {
         // Wayland without proper tools - warn user
@@ -83,9 +95,11 @@ ScreenCaptureEngineFactory::Technology ScreenCaptureEngineFactory::GetBestAvaila
         return Technology::X11;
     }
 #elif defined(__APPLE__)
+    (void)config;
     return Technology::CoreGraphics;
 #else
     // Unknown platform
+    (void)config;
     return Technology::Auto; // This will cause creation to fail
 #endif
 }
@@ -107,6 +121,13 @@ bool ScreenCaptureEngineFactory::IsTechnologySupported(Technology technology)
             return false;
 #endif
 
+        case Technology::XvfbFramebuffer:
+#ifdef __linux__
+            return true;
+#else
+            return false;
+#endif
+
         case Technology::WaylandTool:
 #ifdef __linux__
             // return WaylandToolEngine::IsAvailable();  // Not implemented yet
@@ -140,6 +161,9 @@ std::string ScreenCaptureEngineFactory::GetTechnologyName(Technology technology)
         case Technology::X11:
             return "X11 API (Linux/Unix)";
 
+        case Technology::XvfbFramebuffer:
+            return "Xvfb Framebuffer (Linux)";
+
         case Technology::WaylandTool:
             return "Wayland Tools (Linux)";
 
@@ -180,6 +204,19 @@ std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateX11Engin
 #endif
 }
 
+std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateXvfbFramebufferEngine()
+{
+#ifdef __linux__
+    try {
+        return std::make_unique<XvfbFramebufferCaptureEngine>();
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+#else
+    return nullptr;
+#endif
+}
+
 std::unique_ptr<IScreenCaptureEngine> ScreenCaptureEngineFactory::CreateWaylandToolEngine()
 {
 #ifdef __linux__
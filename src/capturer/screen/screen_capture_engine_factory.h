@@ -29,6 +29,7 @@ public:
     enum class Technology {
         DesktopDuplication, ///< Windows Desktop Duplication API
         X11,                ///< X11 API (Linux/Unix)
+        XvfbFramebuffer,    ///< Memory-mapped Xvfb -fbdir framebuffer (headless Linux)
         WaylandTool,        ///< Wayland system tools (grim, gnome-screenshot, etc.)
         CoreGraphics,       ///< macOS Core Graphics (future support)
         Auto                ///< Automatically detect best available technology
@@ -38,16 +39,19 @@ public:
      * @brief Create a screen capture engine for the specified technology
      *
      * @param technology The target capture technology for the engine
+     * @param config Configuration the engine will be initialized with, used by auto-detection
      * @return std::unique_ptr<IScreenCaptureEngine> Pointer to the created engine, or nullptr on failure
      */
-    static std::unique_ptr<IScreenCaptureEngine> CreateEngine(Technology technology = Technology::Auto);
+    static std::unique_ptr<IScreenCaptureEngine> CreateEngine(Technology technology = Technology::Auto,
+                                                              const ScreenCaptureConfig &config = {});
 
     /**
      * @brief Get the best available technology for current platform
      *
+     * @param config Display and framebuffer directory to detect for (default: $DISPLAY)
      * @return Technology The best available capture technology
      */
-    static Technology GetBestAvailableTechnology();
+    static Technology GetBestAvailableTechnology(const ScreenCaptureConfig &config = {});
 
     /**
      * @brief Check if a platform is supported
@@ -80,6 +84,13 @@ private:
      */
     static std::unique_ptr<IScreenCaptureEngine> CreateX11Engine();
 
+    /**
+     * @brief Create Xvfb framebuffer screen capture engine
+     *
+     * @return std::unique_ptr<IScreenCaptureEngine> Pointer to Xvfb framebuffer engine, or nullptr on failure
+     */
+    static std::unique_ptr<IScreenCaptureEngine> CreateXvfbFramebufferEngine();
+
     /**
      * @brief Create Wayland tool screen capture engine
      *
@@ -18,7 +18,7 @@ ScreenCapturer::ScreenCapturer(const ScreenCaptureConfig &config, ScreenCaptureE
     : config_(config), technology_(technology), initialized_(false)
 {
     // Create the technology-specific engine
-    engine_ = ScreenCaptureEngineFactory::CreateEngine(technology_);
+    engine_ = ScreenCaptureEngineFactory::CreateEngine(technology_, config_);
     if (!engine_) {
         throw std::runtime_error("Failed to create screen capture engine for technology: " +
                                  ScreenCaptureEngineFactory::GetTechnologyName(technology_));
@@ -41,7 +41,7 @@ bool ScreenCapturer::Initialize()
 
     if (initialized_) {
         // Set up frame callback to forward frames to sinks
-        engine_->SetFrameCallback([this](std::shared_ptr<Frame> frame) { OnFrameCaptured(frame); });
+        engine_->SetFrameCallback([this](const std::shared_ptr<Frame> &frame) { OnFrameCaptured(frame); });
     }
 
     return initialized_;
@@ -101,14 +101,66 @@ std::string ScreenCapturer::GetTechnologyName() const
     return ScreenCaptureEngineFactory::GetTechnologyName(technology_);
 }
 
-void ScreenCapturer::OnFrameCaptured(std::shared_ptr<Frame> frame)
+void ScreenCapturer::OnFrameCaptured(const std::shared_ptr<Frame> &frame)
 {
     if (!frame) {
         return;
     }
 
+    MemoryPressure pressure = FrameMemoryGovernor::GetInstance()->GetPressure();
+    if (!AdmitFrame(pressure)) {
+        frames_dropped_for_memory_++;
+        damage_lost_ = true;
+        return;
+    }
+
+    // The rectangles of the dropped frames are not included in this one
+    if (damage_lost_) {
+        frame->dirty_rects.clear();
+        damage_lost_ = false;
+    }
+
     // Forward the frame to all connected sinks using the base class method
-    DeliverFrame(frame);
+    DeliverFrame(pressure == MemoryPressure::ELEVATED ? ReduceResolution(frame) : frame);
+}
+
+bool ScreenCapturer::AdmitFrame(MemoryPressure pressure)
+{
+    uint64_t index = frame_counter_++;
+    switch (pressure) {
+        case MemoryPressure::CRITICAL:
+            return false;
+        case MemoryPressure::ELEVATED:
+            return (index % 2) == 0;
+        default:
+            return true;
+    }
+}
+
+std::shared_ptr<Frame> ScreenCapturer::ReduceResolution(const std::shared_ptr<Frame> &frame)
+{
+    if ((frame->format != FrameFormat::BGRA32 && frame->format != FrameFormat::RGBA32 &&
+         frame->format != FrameFormat::X2RGB10) ||
+        frame->width() < 2 || frame->height() < 2) {
+        return frame;
+    }
+
+    uint32_t width = frame->width() / 2;
+    uint32_t height = frame->height() / 2;
+    if (!pressure_scaler_) {
+        VideoScalerConfig scaler_config;
+        scaler_config.target_width = width;
+        scaler_config.target_height = height;
+        scaler_config.enable_threading = false;
+        pressure_scaler_ = std::make_unique<VideoScaler>(scaler_config);
+        pressure_scaler_->Initialize();
+    } else if (pressure_scaler_->GetTargetWidth() != width || pressure_scaler_->GetTargetHeight() != height) {
+        pressure_scaler_->SetTargetResolution(width, height);
+    }
+
+    // The scaler keeps its own canvas, so dirty rectangles stay usable while degraded
+    auto scaled = pressure_scaler_->Process(frame);
+    return scaled ? scaled : frame;
 }
 
 } // namespace lmshao::remotedesk
\ No newline at end of file
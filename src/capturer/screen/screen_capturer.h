@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
+#include "../../core/frame_memory_governor.h"
 #include "../../core/media_source.h"
+#include "../../processors/video_scaler.h"
 #include "iscreen_capture_engine.h"
 #include "screen_capture_config.h"
 #include "screen_capture_engine_factory.h"
@@ -73,19 +76,41 @@ public:
      */
     std::string GetTechnologyName() const;
 
+    /**
+     * @brief Frames not delivered because of frame memory pressure
+     */
+    uint64_t GetFramesDroppedForMemory() const { return frames_dropped_for_memory_.load(); }
+
 private:
     /**
      * @brief Frame callback handler
      *
      * @param frame Captured frame
      */
-    void OnFrameCaptured(std::shared_ptr<Frame> frame);
+    void OnFrameCaptured(const std::shared_ptr<Frame> &frame);
+
+    /**
+     * @brief Decide whether a captured frame is delivered under the current memory pressure
+     * ELEVATED halves the delivered frame rate, CRITICAL drops every frame until pressure falls.
+     */
+    bool AdmitFrame(MemoryPressure pressure);
+
+    /**
+     * @brief Halve width and height of a frame delivered under ELEVATED pressure
+     * Only packed 32-bit frames are scaled, others are returned unchanged.
+     */
+    std::shared_ptr<Frame> ReduceResolution(const std::shared_ptr<Frame> &frame);
 
 private:
     std::unique_ptr<IScreenCaptureEngine> engine_;      ///< Platform-specific capture engine
     ScreenCaptureConfig config_;                        ///< Current configuration
     ScreenCaptureEngineFactory::Technology technology_; ///< Target technology
     bool initialized_;                                  ///< Initialization state
+
+    uint64_t frame_counter_ = 0;                         ///< Captured frames, for thinning
+    std::atomic<uint64_t> frames_dropped_for_memory_{0}; ///< Frames dropped under pressure
+    std::unique_ptr<VideoScaler> pressure_scaler_;       ///< Created on the first ELEVATED frame
+    bool damage_lost_ = false; ///< A dropped frame carried dirty rectangles, the next one is sent whole
 };
 
 } // namespace lmshao::remotedesk
\ No newline at end of file
@@ -14,7 +14,9 @@
 #include <cstring>
 #include <thread>
 
+#include "../../../core/frame_tracer.h"
 #include "../../../log/remote_desk_log.h"
+#include "../../../processors/packed_rgb_kernels.h"
 
 // X11 headers for real screen capture
 #include <X11/Xlib.h>
@@ -77,6 +79,7 @@ CaptureResult X11ScreenCaptureEngine::Start()
     LOG_DEBUG("Starting X11 screen capture");
 
     should_stop_ = false;
+    heartbeat_ = StageWatchdog::GetInstance()->RegisterStage("capture", config_.display_name, StageKind::LOOP);
     capture_thread_ = std::make_unique<std::thread>(&X11ScreenCaptureEngine::CaptureThreadProc, this);
     is_running_ = true;
 
@@ -99,6 +102,7 @@ void X11ScreenCaptureEngine::Stop()
         capture_thread_->join();
     }
     capture_thread_.reset();
+    heartbeat_.reset();
     is_running_ = false;
 
     LOG_DEBUG("Linux screen capture stopped");
@@ -140,7 +144,7 @@ std::vector<ScreenInfo> X11ScreenCaptureEngine::GetAvailableScreens() const
     return screens;
 }
 
-void X11ScreenCaptureEngine::SetFrameCallback(std::function<void(std::shared_ptr<Frame>)> callback)
+void X11ScreenCaptureEngine::SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback)
 {
     std::lock_guard<std::mutex> lock(mutex_);
     frame_callback_ = callback;
@@ -173,7 +177,7 @@ CaptureResult X11ScreenCaptureEngine::InitializeX11()
     LOG_DEBUG("Initializing X11 display connection");
 
     // Try to open X11 display connection
-    display_ = XOpenDisplay(nullptr);
+    display_ = XOpenDisplay(config_.display_name.empty() ? nullptr : config_.display_name.c_str());
     if (!display_) {
         LOG_ERROR("No X11 display available, this might be a headless environment");
         LOG_ERROR("Consider using Xvfb (virtual framebuffer) for headless screen capture");
@@ -207,10 +211,12 @@ CaptureResult X11ScreenCaptureEngine::InitializeX11()
 void X11ScreenCaptureEngine::CaptureThreadProc()
 {
     LOG_DEBUG("X11 capture loop started");
+    ApplyThreadScheduling(config_.thread_scheduling, "X11 capture");
 
     last_frame_time_ = std::chrono::steady_clock::now();
 
     while (!should_stop_) {
+        heartbeat_->Beat();
         auto current_time = std::chrono::steady_clock::now();
         auto elapsed = current_time - last_frame_time_;
 
@@ -233,6 +239,7 @@ CaptureResult X11ScreenCaptureEngine::CaptureFrame()
     }
 
     std::shared_ptr<Frame> frame;
+    int64_t capture_begin_ns = FrameTracer::Now();
 
     // In demo mode, only use XGetImage simulation
     frame = CaptureFrameXGetImage();
@@ -245,6 +252,7 @@ CaptureResult X11ScreenCaptureEngine::CaptureFrame()
     frame->timestamp =
         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
             .count();
+    FrameTracer::Record("XGetImage", TraceCategory::CAPTURE, frame->timestamp, capture_begin_ns, FrameTracer::Now());
 
     // Deliver the frame
     frame_callback_(frame);
@@ -304,7 +312,9 @@ std::shared_ptr<Frame> X11ScreenCaptureEngine::ConvertXImageToFrame(XImage *xima
     frame->video_info.framerate = config_.frame_rate;
 
     // Determine format based on XImage properties (raw data from X11)
+    enum class Unpack { COPY, RGB565, SWAP_RED_BLUE };
     FrameFormat detected_format = FrameFormat::UNKNOWN;
+    Unpack unpack = Unpack::COPY;
     if (ximage->depth == 24 && ximage->bits_per_pixel == 32) {
         // Check color masks to determine exact format
         if (ximage->red_mask == 0x00FF0000 && ximage->green_mask == 0x0000FF00 && ximage->blue_mask == 0x000000FF) {
@@ -313,35 +323,65 @@ std::shared_ptr<Frame> X11ScreenCaptureEngine::ConvertXImageToFrame(XImage *xima
                    ximage->blue_mask == 0x00FF0000) {
             detected_format = FrameFormat::RGBA32;
         }
+    } else if (ximage->depth == 30 && ximage->bits_per_pixel == 32 && ximage->green_mask == 0x000FFC00) {
+        // 10 bits per channel, kept at full precision
+        if (ximage->red_mask == 0x3FF00000 && ximage->blue_mask == 0x000003FF) {
+            detected_format = FrameFormat::X2RGB10;
+        } else if (ximage->red_mask == 0x000003FF && ximage->blue_mask == 0x3FF00000) {
+            detected_format = FrameFormat::X2RGB10;
+            unpack = Unpack::SWAP_RED_BLUE;
+        }
+    } else if (ximage->depth == 16 && ximage->bits_per_pixel == 16 && ximage->red_mask == 0xF800 &&
+               ximage->green_mask == 0x07E0 && ximage->blue_mask == 0x001F) {
+        detected_format = FrameFormat::BGRA32;
+        unpack = Unpack::RGB565;
+    }
+
+    if (detected_format == FrameFormat::UNKNOWN) {
+        if (!unsupported_visual_logged_) {
+            LOG_ERROR("Unsupported X11 visual: depth=%d, bits_per_pixel=%d, masks=%06lx/%06lx/%06lx", ximage->depth,
+                      ximage->bits_per_pixel, ximage->red_mask, ximage->green_mask, ximage->blue_mask);
+            unsupported_visual_logged_ = true;
+        }
+        return nullptr;
     }
 
     // Set format to the detected raw format from X11
     frame->format = detected_format;
 
     // Calculate frame size
-    size_t frame_size = ximage->width * ximage->height * 4; // 4 bytes per pixel
+    const size_t row_bytes = static_cast<size_t>(ximage->width) * 4; // 4 bytes per output pixel
+    size_t frame_size = row_bytes * ximage->height;
     frame->SetSize(frame_size);
+    frame->stride = static_cast<uint32_t>(row_bytes);
 
-    LOG_DEBUG("Direct raw format output: depth=%d, bits_per_pixel=%d, format=%s", ximage->depth, ximage->bits_per_pixel,
-              detected_format == FrameFormat::BGRA32   ? "BGRA32"
-              : detected_format == FrameFormat::RGBA32 ? "RGBA32"
-                                                       : "UNKNOWN");
+    LOG_DEBUG("Direct raw format output: depth=%d, bits_per_pixel=%d, format=%d", ximage->depth, ximage->bits_per_pixel,
+              static_cast<int>(detected_format));
 
-    // Direct memory copy - no conversion needed
-    if (detected_format != FrameFormat::UNKNOWN && ximage->bytes_per_line == ximage->width * 4) {
+    uint8_t *dst = frame->Data();
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(ximage->data);
+    if (unpack == Unpack::COPY && static_cast<size_t>(ximage->bytes_per_line) == row_bytes) {
         // Direct memory copy for optimal performance
-        std::memcpy(frame->Data(), ximage->data, frame_size);
+        std::memcpy(dst, src, frame_size);
         LOG_DEBUG("Zero-copy direct memory transfer completed for %d pixels", ximage->width * ximage->height);
     } else {
-        // Fallback: copy row by row if memory layout is not contiguous
-        uint8_t *dst = (uint8_t *)frame->Data();
-        const uint8_t *src = (const uint8_t *)ximage->data;
-        const int row_bytes = ximage->width * 4;
-
+        // Row by row: padded rows, or pixels that are unpacked on the way
         for (int y = 0; y < ximage->height; ++y) {
-            std::memcpy(dst + y * row_bytes, src + y * ximage->bytes_per_line, row_bytes);
+            const uint8_t *src_row = src + static_cast<size_t>(y) * ximage->bytes_per_line;
+            uint8_t *dst_row = dst + y * row_bytes;
+            switch (unpack) {
+                case Unpack::RGB565:
+                    UnpackRgb565ToBgra32(src_row, dst_row, ximage->width);
+                    break;
+                case Unpack::SWAP_RED_BLUE:
+                    SwapX2Rgb10RedBlue(src_row, dst_row, ximage->width);
+                    break;
+                default:
+                    std::memcpy(dst_row, src_row, row_bytes);
+                    break;
+            }
         }
-        LOG_DEBUG("Row-by-row memory copy completed for %dx%d image", ximage->width, ximage->height);
+        LOG_DEBUG("Row-by-row conversion completed for %dx%d image", ximage->width, ximage->height);
     }
 
     return frame;
@@ -349,7 +389,7 @@ std::shared_ptr<Frame> X11ScreenCaptureEngine::ConvertXImageToFrame(XImage *xima
 
 // Note: Format conversion functions removed - now using direct raw format output
 
-void X11ScreenCaptureEngine::CaptureCursor(std::shared_ptr<Frame> frame)
+void X11ScreenCaptureEngine::CaptureCursor(const std::shared_ptr<Frame> &frame)
 {
     // Cursor capture not available in demo mode
     // In a real implementation, this would overlay cursor image onto the frame
@@ -17,6 +17,7 @@
 #include <mutex>
 #include <thread>
 
+#include "../../../core/stage_watchdog.h"
 #include "../iscreen_capture_engine.h"
 
 // X11 forward declarations
@@ -38,7 +39,7 @@ public:
     void Stop() override;
     bool IsRunning() const override;
     std::vector<ScreenInfo> GetAvailableScreens() const override;
-    void SetFrameCallback(std::function<void(std::shared_ptr<Frame>)> callback) override;
+    void SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback) override;
     const ScreenCaptureConfig &GetConfig() const override;
     CaptureResult UpdateConfig(const ScreenCaptureConfig &config) override;
 
@@ -68,8 +69,10 @@ private:
 
     /**
      * @brief Convert XImage to Frame format
+     * Depth-24 visuals are copied as BGRA32/RGBA32, depth-30 visuals as X2RGB10 (red and
+     * blue swapped if needed) and depth-16 RGB565 visuals are unpacked to BGRA32.
      * @param ximage X11 image to convert
-     * @return Shared pointer to frame data
+     * @return Shared pointer to frame data, nullptr for other visuals
      */
     std::shared_ptr<Frame> ConvertXImageToFrame(XImage *ximage);
 
@@ -77,7 +80,7 @@ private:
      * @brief Capture cursor if enabled
      * @param frame Frame to overlay cursor on
      */
-    void CaptureCursor(std::shared_ptr<Frame> frame);
+    void CaptureCursor(const std::shared_ptr<Frame> &frame);
 
     /**
      * @brief Cleanup X11 resources
@@ -105,6 +108,7 @@ private:
     // Capture thread
     std::unique_ptr<std::thread> capture_thread_;
     std::atomic<bool> should_stop_{false};
+    std::shared_ptr<StageHeartbeat> heartbeat_; // Capture loop progress, watched by StageWatchdog
     mutable std::mutex mutex_;
 
     // Frame timing
@@ -116,6 +120,8 @@ private:
     int capture_y_;
     uint32_t capture_width_;
     uint32_t capture_height_;
+
+    bool unsupported_visual_logged_ = false;
 };
 
 } // namespace lmshao::remotedesk
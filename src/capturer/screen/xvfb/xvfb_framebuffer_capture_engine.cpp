@@ -0,0 +1,481 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifdef __linux__
+
+#include "xvfb_framebuffer_capture_engine.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <X11/XWDFile.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "../../../core/frame_tracer.h"
+#include "../../../log/remote_desk_log.h"
+
+// Undefine X11 macros that conflict with our enums
+#ifdef Success
+#undef Success
+#endif
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+constexpr uint32_t XWD_LSB_FIRST = 0; // LSBFirst from X.h
+
+// Beyond this many damage rectangles the frame is reported as wholly changed
+constexpr int MAX_DIRTY_RECTS = 64;
+
+uint32_t SwapBytes(uint32_t value)
+{
+    return ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) | ((value >> 8) & 0xFF00) | (value >> 24);
+}
+
+} // namespace
+
+XvfbFramebufferCaptureEngine::XvfbFramebufferCaptureEngine()
+{
+    LOG_DEBUG("XvfbFramebufferCaptureEngine created");
+}
+
+XvfbFramebufferCaptureEngine::~XvfbFramebufferCaptureEngine()
+{
+    Stop();
+    Cleanup();
+    LOG_DEBUG("XvfbFramebufferCaptureEngine destroyed");
+}
+
+std::string XvfbFramebufferCaptureEngine::GetFramebufferPath(const ScreenCaptureConfig &config, uint32_t screen)
+{
+    std::string dir = config.framebuffer_dir;
+    if (dir.empty() && config.display_name.empty()) {
+        const char *env = std::getenv("XVFB_FBDIR");
+        dir = env ? env : "";
+    }
+    if (dir.empty()) {
+        return "";
+    }
+    if (dir.back() != '/') {
+        dir += '/';
+    }
+    return dir + "Xvfb_screen" + std::to_string(screen);
+}
+
+CaptureResult XvfbFramebufferCaptureEngine::Initialize(const ScreenCaptureConfig &config)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (is_running_) {
+        LOG_ERROR("Cannot initialize while capture is running");
+        return CaptureResult::ErrorInitialization;
+    }
+
+    Cleanup();
+
+    config_ = config;
+    frame_interval_ = std::chrono::milliseconds(1000 / std::max(1u, config_.frame_rate));
+
+    auto result = MapFramebuffer();
+    if (result != CaptureResult::Success) {
+        return result;
+    }
+
+    // Clip the requested region to the framebuffer
+    if (config_.width > 0 && config_.height > 0) {
+        capture_x_ = std::min<uint32_t>(std::max(0, config_.offset_x), fb_width_ - 1);
+        capture_y_ = std::min<uint32_t>(std::max(0, config_.offset_y), fb_height_ - 1);
+        capture_width_ = std::min(config_.width, fb_width_ - capture_x_);
+        capture_height_ = std::min(config_.height, fb_height_ - capture_y_);
+    } else {
+        capture_x_ = 0;
+        capture_y_ = 0;
+        capture_width_ = fb_width_;
+        capture_height_ = fb_height_;
+    }
+
+    InitializeDamage();
+
+    LOG_DEBUG("Xvfb framebuffer capture initialized: %s, %ux%u at (%u,%u)", framebuffer_path_.c_str(), capture_width_,
+              capture_height_, capture_x_, capture_y_);
+    return CaptureResult::Success;
+}
+
+CaptureResult XvfbFramebufferCaptureEngine::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (is_running_) {
+        return CaptureResult::Success;
+    }
+    if (!pixels_) {
+        LOG_ERROR("Xvfb framebuffer is not mapped, call Initialize first");
+        return CaptureResult::ErrorInitialization;
+    }
+
+    should_stop_ = false;
+    deliver_next_ = true;
+    heartbeat_ = StageWatchdog::GetInstance()->RegisterStage("capture", config_.display_name, StageKind::LOOP);
+    capture_thread_ = std::make_unique<std::thread>(&XvfbFramebufferCaptureEngine::CaptureThreadProc, this);
+    is_running_ = true;
+
+    LOG_DEBUG("Xvfb framebuffer capture started");
+    return CaptureResult::Success;
+}
+
+void XvfbFramebufferCaptureEngine::Stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_running_) {
+        return;
+    }
+
+    should_stop_ = true;
+    if (capture_thread_ && capture_thread_->joinable()) {
+        capture_thread_->join();
+    }
+    capture_thread_.reset();
+    heartbeat_.reset();
+    is_running_ = false;
+
+    LOG_DEBUG("Xvfb framebuffer capture stopped");
+}
+
+bool XvfbFramebufferCaptureEngine::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return is_running_;
+}
+
+std::vector<ScreenInfo> XvfbFramebufferCaptureEngine::GetAvailableScreens() const
+{
+    std::vector<ScreenInfo> screens;
+
+    // Xvfb numbers its framebuffer files like its screens
+    for (uint32_t i = 0;; ++i) {
+        std::string path = GetFramebufferPath(config_, i);
+        struct stat st;
+        if (path.empty() || stat(path.c_str(), &st) != 0) {
+            break;
+        }
+
+        ScreenInfo screen_info;
+        screen_info.id = i;
+        screen_info.name = path;
+        screen_info.width = i == config_.monitor_index ? fb_width_ : 0;
+        screen_info.height = i == config_.monitor_index ? fb_height_ : 0;
+        screen_info.bits_per_pixel = 32;
+        screen_info.is_primary = (i == 0);
+        screens.push_back(screen_info);
+    }
+
+    return screens;
+}
+
+void XvfbFramebufferCaptureEngine::SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_callback_ = callback;
+}
+
+const ScreenCaptureConfig &XvfbFramebufferCaptureEngine::GetConfig() const
+{
+    return config_;
+}
+
+CaptureResult XvfbFramebufferCaptureEngine::UpdateConfig(const ScreenCaptureConfig &config)
+{
+    bool was_running = IsRunning();
+    if (was_running) {
+        Stop();
+    }
+
+    auto result = Initialize(config);
+    if (result == CaptureResult::Success && was_running) {
+        result = Start();
+    }
+
+    return result;
+}
+
+CaptureResult XvfbFramebufferCaptureEngine::MapFramebuffer()
+{
+    framebuffer_path_ = GetFramebufferPath(config_, config_.monitor_index);
+    if (framebuffer_path_.empty() && !config_.display_name.empty()) {
+        LOG_ERROR("No Xvfb framebuffer directory for display %s, set framebuffer_dir (Xvfb -fbdir)",
+                  config_.display_name.c_str());
+        return CaptureResult::ErrorInvalidConfig;
+    }
+    if (framebuffer_path_.empty()) {
+        LOG_ERROR("No Xvfb framebuffer directory, set framebuffer_dir or XVFB_FBDIR (Xvfb -fbdir)");
+        return CaptureResult::ErrorInvalidConfig;
+    }
+
+    int fd = open(framebuffer_path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open Xvfb framebuffer %s: %s", framebuffer_path_.c_str(), strerror(errno));
+        return CaptureResult::ErrorNoDisplay;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sz_XWDheader) {
+        LOG_ERROR("Xvfb framebuffer %s is too small", framebuffer_path_.c_str());
+        close(fd);
+        return CaptureResult::ErrorInitialization;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    mapping_size_ = static_cast<size_t>(st.st_size);
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping_ == MAP_FAILED) {
+        LOG_ERROR("Failed to map Xvfb framebuffer %s: %s", framebuffer_path_.c_str(), strerror(errno));
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+        return CaptureResult::ErrorInitialization;
+    }
+
+    // XWD headers are specified most significant byte first; accept both orders
+    XWDFileHeader header;
+    std::memcpy(&header, mapping_, sz_XWDheader);
+    if (header.file_version != XWD_FILE_VERSION) {
+        uint32_t *fields = reinterpret_cast<uint32_t *>(&header);
+        for (size_t i = 0; i < sz_XWDheader / sizeof(uint32_t); ++i) {
+            fields[i] = SwapBytes(fields[i]);
+        }
+    }
+    if (header.file_version != XWD_FILE_VERSION) {
+        LOG_ERROR("%s is not an XWD framebuffer (version %u)", framebuffer_path_.c_str(), header.file_version);
+        UnmapFramebuffer();
+        return CaptureResult::ErrorInitialization;
+    }
+
+    size_t data_offset = header.header_size + static_cast<size_t>(header.ncolors) * sz_XWDColor;
+    size_t data_size = static_cast<size_t>(header.bytes_per_line) * header.pixmap_height;
+    if (data_offset + data_size > mapping_size_) {
+        LOG_ERROR("Xvfb framebuffer %s is truncated", framebuffer_path_.c_str());
+        UnmapFramebuffer();
+        return CaptureResult::ErrorInitialization;
+    }
+
+    fb_format_ = FrameFormat::UNKNOWN;
+    if (header.bits_per_pixel == 32 && header.byte_order == XWD_LSB_FIRST) {
+        if (header.red_mask == 0x00FF0000 && header.green_mask == 0x0000FF00 && header.blue_mask == 0x000000FF) {
+            fb_format_ = FrameFormat::BGRA32;
+        } else if (header.red_mask == 0x000000FF && header.green_mask == 0x0000FF00 &&
+                   header.blue_mask == 0x00FF0000) {
+            fb_format_ = FrameFormat::RGBA32;
+        }
+    }
+    if (fb_format_ == FrameFormat::UNKNOWN) {
+        LOG_ERROR("Unsupported Xvfb framebuffer layout: %u bpp, byte order %u (start Xvfb with depth 24)",
+                  header.bits_per_pixel, header.byte_order);
+        UnmapFramebuffer();
+        return CaptureResult::NotSupported;
+    }
+
+    pixels_ = static_cast<const uint8_t *>(mapping_) + data_offset;
+    if (config_.lock_memory) {
+        LockMemoryRange(mapping_, mapping_size_, "Xvfb framebuffer");
+    }
+    fb_width_ = header.pixmap_width;
+    fb_height_ = header.pixmap_height;
+    fb_bytes_per_line_ = header.bytes_per_line;
+    return CaptureResult::Success;
+}
+
+void XvfbFramebufferCaptureEngine::UnmapFramebuffer()
+{
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    pixels_ = nullptr;
+}
+
+void XvfbFramebufferCaptureEngine::InitializeDamage()
+{
+#ifdef HAVE_XDAMAGE
+    display_ = XOpenDisplay(config_.display_name.empty() ? nullptr : config_.display_name.c_str());
+    if (!display_) {
+        LOG_WARN("No X display for damage tracking, capturing every frame");
+        return;
+    }
+
+    int error_base = 0;
+    if (!XDamageQueryExtension(display_, &damage_event_base_, &error_base)) {
+        LOG_WARN("XDamage extension not available, capturing every frame");
+        XCloseDisplay(display_);
+        display_ = nullptr;
+        return;
+    }
+
+    // One notification until the damage is subtracted again
+    damage_ = XDamageCreate(display_, DefaultRootWindow(display_), XDamageReportNonEmpty);
+    damage_region_ = XFixesCreateRegion(display_, nullptr, 0);
+    XFlush(display_);
+#endif
+}
+
+bool XvfbFramebufferCaptureEngine::ConsumeDamage(std::vector<FrameRect> &dirty_rects)
+{
+    dirty_rects.clear();
+#ifdef HAVE_XDAMAGE
+    if (!display_ || !damage_) {
+        return true;
+    }
+
+    bool damaged = false;
+    while (XPending(display_) > 0) {
+        XEvent event;
+        XNextEvent(display_, &event);
+        if (event.type == damage_event_base_ + XDamageNotify) {
+            damaged = true;
+        }
+    }
+
+    if (!damaged) {
+        return false;
+    }
+
+    // Subtract before copying, so that drawing during the copy raises a new notification
+    XDamageSubtract(display_, damage_, None, damage_region_);
+    XFlush(display_);
+
+    int count = 0;
+    XRectangle *rects = XFixesFetchRegion(display_, damage_region_, &count);
+    if (!rects) {
+        return true;
+    }
+
+    // Root window coordinates, clipped and translated to the capture region
+    const int region_right = static_cast<int>(capture_x_ + capture_width_);
+    const int region_bottom = static_cast<int>(capture_y_ + capture_height_);
+    for (int i = 0; i < count && count <= MAX_DIRTY_RECTS; ++i) {
+        int left = std::max<int>(rects[i].x, capture_x_);
+        int top = std::max<int>(rects[i].y, capture_y_);
+        int right = std::min<int>(rects[i].x + rects[i].width, region_right);
+        int bottom = std::min<int>(rects[i].y + rects[i].height, region_bottom);
+        if (left < right && top < bottom) {
+            FrameRect rect;
+            rect.x = static_cast<uint16_t>(left - capture_x_);
+            rect.y = static_cast<uint16_t>(top - capture_y_);
+            rect.width = static_cast<uint16_t>(right - left);
+            rect.height = static_cast<uint16_t>(bottom - top);
+            dirty_rects.push_back(rect);
+        }
+    }
+    XFree(rects);
+
+    // Damage outside the capture region does not need a frame
+    return count > MAX_DIRTY_RECTS || !dirty_rects.empty();
+#else
+    return true;
+#endif
+}
+
+void XvfbFramebufferCaptureEngine::CaptureThreadProc()
+{
+    LOG_DEBUG("Xvfb capture loop started");
+    ApplyThreadScheduling(config_.thread_scheduling, "Xvfb capture");
+
+    auto next_frame_time = std::chrono::steady_clock::now();
+    std::vector<FrameRect> dirty_rects;
+    while (!should_stop_) {
+        heartbeat_->Beat();
+        bool damaged = ConsumeDamage(dirty_rects);
+        if (damaged || deliver_next_) {
+            // Rectangles only describe the change from the previous delivered frame
+            int64_t capture_begin_ns = FrameTracer::Now();
+            auto frame = CaptureFrame();
+            if (frame) {
+                FrameTracer::Record("framebuffer copy", TraceCategory::CAPTURE, frame->timestamp, capture_begin_ns,
+                                    FrameTracer::Now());
+                if (!deliver_next_) {
+                    frame->dirty_rects.swap(dirty_rects);
+                }
+                deliver_next_ = false;
+                if (frame_callback_) {
+                    frame_callback_(frame);
+                }
+            }
+        }
+
+        next_frame_time += frame_interval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next_frame_time < now) {
+            next_frame_time = now; // Fell behind, do not try to catch up
+        }
+        std::this_thread::sleep_until(next_frame_time);
+    }
+
+    LOG_DEBUG("Xvfb capture loop ended");
+}
+
+std::shared_ptr<Frame> XvfbFramebufferCaptureEngine::CaptureFrame()
+{
+    if (!pixels_ || capture_width_ == 0 || capture_height_ == 0) {
+        return nullptr;
+    }
+
+    const size_t row_bytes = static_cast<size_t>(capture_width_) * 4;
+    auto frame = std::make_shared<Frame>(row_bytes * capture_height_);
+    frame->SetSize(row_bytes * capture_height_);
+    frame->format = fb_format_;
+    frame->video_info.width = capture_width_;
+    frame->video_info.height = capture_height_;
+    frame->video_info.framerate = config_.frame_rate;
+    frame->stride = static_cast<uint32_t>(row_bytes);
+
+    const uint8_t *src = pixels_ + static_cast<size_t>(capture_y_) * fb_bytes_per_line_ + capture_x_ * 4;
+    uint8_t *dst = frame->Data();
+    if (capture_x_ == 0 && row_bytes == fb_bytes_per_line_) {
+        std::memcpy(dst, src, row_bytes * capture_height_);
+    } else {
+        for (uint32_t y = 0; y < capture_height_; ++y) {
+            std::memcpy(dst + y * row_bytes, src + y * fb_bytes_per_line_, row_bytes);
+        }
+    }
+
+    frame->timestamp =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    return frame;
+}
+
+void XvfbFramebufferCaptureEngine::Cleanup()
+{
+#ifdef HAVE_XDAMAGE
+    if (display_) {
+        if (damage_) {
+            XDamageDestroy(display_, damage_);
+            damage_ = 0;
+        }
+        if (damage_region_) {
+            XFixesDestroyRegion(display_, damage_region_);
+            damage_region_ = 0;
+        }
+        XCloseDisplay(display_);
+        display_ = nullptr;
+    }
+#endif
+    UnmapFramebuffer();
+}
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
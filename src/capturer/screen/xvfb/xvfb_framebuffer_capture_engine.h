@@ -0,0 +1,143 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_XVFB_FRAMEBUFFER_CAPTURE_ENGINE_H
+#define LMSHAO_REMOTE_DESK_XVFB_FRAMEBUFFER_CAPTURE_ENGINE_H
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../core/stage_watchdog.h"
+#include "../iscreen_capture_engine.h"
+
+#ifdef HAVE_XDAMAGE
+#include <X11/Xlib.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
+#endif
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Capture engine reading the Xvfb framebuffer file directly
+ * Xvfb started with "-fbdir <dir>" keeps each screen in <dir>/Xvfb_screen<N>
+ * as an XWD file backed by a shared mapping. The engine maps that file
+ * read-only and copies pixels straight out of it: there is no X protocol
+ * round trip per frame. When built with XDamage (HAVE_XDAMAGE) the engine
+ * additionally subscribes to damage on the root window and skips ticks on
+ * which nothing changed.
+ */
+class XvfbFramebufferCaptureEngine : public IScreenCaptureEngine {
+public:
+    XvfbFramebufferCaptureEngine();
+    ~XvfbFramebufferCaptureEngine() override;
+
+    // IScreenCaptureEngine implementation
+    CaptureResult Initialize(const ScreenCaptureConfig &config) override;
+    CaptureResult Start() override;
+    void Stop() override;
+    bool IsRunning() const override;
+    std::vector<ScreenInfo> GetAvailableScreens() const override;
+    void SetFrameCallback(std::function<void(const std::shared_ptr<Frame> &)> callback) override;
+    const ScreenCaptureConfig &GetConfig() const override;
+    CaptureResult UpdateConfig(const ScreenCaptureConfig &config) override;
+
+    /**
+     * @brief Framebuffer file of a screen: <framebuffer_dir>/Xvfb_screen<screen>
+     * An empty framebuffer_dir falls back to the XVFB_FBDIR environment variable, which
+     * belongs to $DISPLAY; a config naming its display_name must set framebuffer_dir.
+     * @return Empty if no directory applies to the configured display
+     */
+    static std::string GetFramebufferPath(const ScreenCaptureConfig &config, uint32_t screen);
+
+private:
+    /**
+     * @brief Map the framebuffer file and parse its XWD header
+     */
+    CaptureResult MapFramebuffer();
+
+    /**
+     * @brief Unmap the framebuffer file
+     */
+    void UnmapFramebuffer();
+
+    /**
+     * @brief Subscribe to damage events on the root window (no-op without HAVE_XDAMAGE)
+     */
+    void InitializeDamage();
+
+    /**
+     * @brief Drain pending damage events
+     * @param dirty_rects Changed rectangles inside the capture region, left empty when unknown
+     * @return true if the capture region changed since the last call, always true without XDamage
+     */
+    bool ConsumeDamage(std::vector<FrameRect> &dirty_rects);
+
+    /**
+     * @brief Capture thread main function
+     */
+    void CaptureThreadProc();
+
+    /**
+     * @brief Copy the capture region out of the mapped framebuffer
+     */
+    std::shared_ptr<Frame> CaptureFrame();
+
+    /**
+     * @brief Cleanup mapping and X resources
+     */
+    void Cleanup();
+
+private:
+    // Mapped framebuffer
+    std::string framebuffer_path_;
+    void *mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const uint8_t *pixels_ = nullptr;
+    uint32_t fb_width_ = 0;
+    uint32_t fb_height_ = 0;
+    uint32_t fb_bytes_per_line_ = 0;
+    FrameFormat fb_format_ = FrameFormat::UNKNOWN;
+
+#ifdef HAVE_XDAMAGE
+    // Damage tracking
+    Display *display_ = nullptr;
+    Damage damage_ = 0;
+    XserverRegion damage_region_ = 0; // Receives the damage on each subtract
+    int damage_event_base_ = 0;
+#endif
+
+    // Capture thread
+    std::unique_ptr<std::thread> capture_thread_;
+    std::atomic<bool> should_stop_{false};
+    std::shared_ptr<StageHeartbeat> heartbeat_; // Capture loop progress, watched by StageWatchdog
+    mutable std::mutex mutex_;
+
+    // Frame timing
+    std::chrono::milliseconds frame_interval_{33};
+    bool deliver_next_ = true; // First frame after start is delivered whatever the damage says
+
+    // Capture region
+    uint32_t capture_x_ = 0;
+    uint32_t capture_y_ = 0;
+    uint32_t capture_width_ = 0;
+    uint32_t capture_height_ = 0;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
+
+#endif // LMSHAO_REMOTE_DESK_XVFB_FRAMEBUFFER_CAPTURE_ENGINE_H
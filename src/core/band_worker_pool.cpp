@@ -0,0 +1,82 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "band_worker_pool.h"
+
+namespace lmshao::remotedesk {
+
+BandWorkerPool::BandWorkerPool(size_t thread_count)
+{
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&BandWorkerPool::WorkerThreadProc, this);
+    }
+}
+
+BandWorkerPool::~BandWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void BandWorkerPool::Run(size_t band_count, const BandJob &job)
+{
+    if (band_count == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_ = &job;
+    band_count_ = band_count;
+    next_band_ = 0;
+    bands_pending_ = band_count;
+    if (band_count > 1) {
+        work_cv_.notify_all();
+    }
+
+    // The calling thread works too instead of only waiting
+    while (next_band_ < band_count_) {
+        size_t band = next_band_++;
+        lock.unlock();
+        job(band);
+        lock.lock();
+        bands_pending_--;
+    }
+
+    done_cv_.wait(lock, [this] { return bands_pending_ == 0; });
+    job_ = nullptr;
+}
+
+void BandWorkerPool::WorkerThreadProc()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this] { return stopping_ || (job_ && next_band_ < band_count_); });
+        if (stopping_) {
+            return;
+        }
+
+        size_t band = next_band_++;
+        const BandJob *job = job_;
+        lock.unlock();
+        (*job)(band);
+        lock.lock();
+        if (--bands_pending_ == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+} // namespace lmshao::remotedesk
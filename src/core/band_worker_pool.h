@@ -0,0 +1,67 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_BAND_WORKER_POOL_H
+#define LMSHAO_REMOTE_DESK_BAND_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Persistent threads that split one job into bands and run them in parallel
+ * Run() hands the bands of a job to the workers and takes bands itself until
+ * none is left, then waits for the ones still running. The threads live as
+ * long as the pool, so a per-frame job pays a wakeup instead of a thread
+ * start. Run() is meant for one caller at a time, such as the processing
+ * thread of a converter.
+ */
+class BandWorkerPool {
+public:
+    using BandJob = std::function<void(size_t band)>;
+
+    /**
+     * @param thread_count Worker threads besides the thread calling Run()
+     */
+    explicit BandWorkerPool(size_t thread_count);
+    ~BandWorkerPool();
+
+    BandWorkerPool(const BandWorkerPool &) = delete;
+    BandWorkerPool &operator=(const BandWorkerPool &) = delete;
+
+    size_t GetThreadCount() const { return workers_.size(); }
+
+    /**
+     * @brief Call job(0) to job(band_count - 1), returns once every call completed
+     */
+    void Run(size_t band_count, const BandJob &job);
+
+private:
+    void WorkerThreadProc();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<std::thread> workers_;
+
+    const BandJob *job_ = nullptr;
+    size_t band_count_ = 0;
+    size_t next_band_ = 0;
+    size_t bands_pending_ = 0; // Bands not completed yet
+    bool stopping_ = false;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_BAND_WORKER_POOL_H
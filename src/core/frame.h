@@ -12,6 +12,11 @@
 #include <coreutils/data_buffer.h>
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "frame_memory_governor.h"
 
 namespace lmshao::remotedesk {
 
@@ -32,6 +37,10 @@ enum class FrameFormat : int {
     H265 = 108,
     VP8 = 109,
     VP9 = 110,
+    MJPEG = 111,
+    I444 = 112,    // Planar YUV 4:4:4, full chroma resolution
+    I010 = 113,    // Planar YUV 4:2:0, 10-bit samples in 16-bit little-endian words
+    X2RGB10 = 114, // 32-bit little-endian words: 2 unused bits, then 10-bit R, G and B (depth-30 visuals)
 
     // Audio formats (200-299)
     AUDIO_BASE = 200,
@@ -55,6 +64,24 @@ struct VideoFrameInfo {
     uint16_t height = 0;
     uint32_t framerate = 0;
     bool is_keyframe = false;
+
+    // Temporal layer of an encoded frame (see VideoEncoderConfig::temporal_layers)
+    uint8_t temporal_id = 0;
+
+    // Encoded frame held as a long-term reference, receivers acknowledge it by timestamp
+    bool long_term_reference = false;
+};
+
+/**
+ * @brief Rectangle inside a video frame, in pixels
+ */
+struct FrameRect {
+    uint16_t x = 0;
+    uint16_t y = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    bool IsEmpty() const { return width == 0 || height == 0; }
 };
 
 struct AudioFrameInfo {
@@ -69,6 +96,25 @@ public:
     template <typename... Args>
     explicit Frame(Args... args) : DataBuffer(args...)
     {
+        UpdateMemoryAccounting();
+    }
+
+    ~Frame() { FrameMemoryGovernor::TrackFrame(-static_cast<int64_t>(accounted_bytes_), -1); }
+
+    // Frames are shared through std::shared_ptr, never copied
+    Frame(const Frame &) = delete;
+    Frame &operator=(const Frame &) = delete;
+
+    // Buffer growth is reported to FrameMemoryGovernor
+    void SetSize(size_t size)
+    {
+        DataBuffer::SetSize(size);
+        UpdateMemoryAccounting();
+    }
+    void SetCapacity(size_t capacity)
+    {
+        DataBuffer::SetCapacity(capacity);
+        UpdateMemoryAccounting();
     }
 
     int64_t timestamp = 0;
@@ -82,6 +128,11 @@ public:
     // Convenience properties for video frames
     uint32_t stride = 0; // Row stride for video frames
 
+    // Regions changed since the previous frame of the same stream, empty when unknown (whole frame changed).
+    // A stage that drops a frame carrying rectangles must clear them on the next frame it forwards if it
+    // owns that frame, or else call MediaProcessor::OnFramesDropped() on the next stage.
+    std::vector<FrameRect> dirty_rects;
+
     // Convenience accessors for video frames
     uint16_t &width() { return video_info.width; }
     const uint16_t &width() const { return video_info.width; }
@@ -93,8 +144,45 @@ public:
     bool IsValid() const { return Data() != nullptr && Size() > 0; }
     bool IsVideo() const { return GetFrameType(format) == FrameFormat::VIDEO_BASE; }
     bool IsAudio() const { return GetFrameType(format) == FrameFormat::AUDIO_BASE; }
+
+private:
+    void UpdateMemoryAccounting()
+    {
+        size_t capacity = Capacity();
+        if (capacity != accounted_bytes_ || !tracked_) {
+            FrameMemoryGovernor::TrackFrame(static_cast<int64_t>(capacity) - static_cast<int64_t>(accounted_bytes_),
+                                            tracked_ ? 0 : 1);
+            accounted_bytes_ = capacity;
+            tracked_ = true;
+        }
+    }
+
+    size_t accounted_bytes_ = 0;
+    bool tracked_ = false;
 };
 
+/**
+ * @brief Frame for a stage to write its next output into, for stages that update their last output
+ * The published canvas is reused once every downstream reference is gone, otherwise a new frame is
+ * allocated so that frames already delivered never change. A result other than canvas means the
+ * content was copied when preserve is set.
+ * @param canvas Last output of the stage, may be null
+ * @param preserve Keep the canvas content (incremental update)
+ */
+inline std::shared_ptr<Frame> AcquireCanvas(const std::shared_ptr<Frame> &canvas, size_t size, bool preserve)
+{
+    if (canvas && canvas.use_count() == 1 && canvas->Size() == size) {
+        return canvas;
+    }
+
+    auto frame = std::make_shared<Frame>(size);
+    frame->SetSize(size);
+    if (preserve && canvas) {
+        std::memcpy(frame->Data(), canvas->Data(), size);
+    }
+    return frame;
+}
+
 } // namespace lmshao::remotedesk
 
 #endif // LMSHAO_REMOTE_DESK_FRAME_H
@@ -0,0 +1,62 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "frame_memory_governor.h"
+
+#include <algorithm>
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+void FrameMemoryGovernor::SetBudget(size_t budget_bytes, double high_watermark)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_bytes_ = budget_bytes;
+        if (budget_bytes == 0) {
+            budget_limit_.store(INT64_MAX, std::memory_order_relaxed);
+            high_watermark_.store(INT64_MAX, std::memory_order_relaxed);
+        } else {
+            budget_limit_.store(static_cast<int64_t>(budget_bytes), std::memory_order_relaxed);
+            double fraction = std::clamp(high_watermark, 0.0, 1.0);
+            high_watermark_.store(static_cast<int64_t>(static_cast<double>(budget_bytes) * fraction),
+                                  std::memory_order_relaxed);
+        }
+    }
+    UpdatePressure();
+}
+
+FrameMemoryGovernor::MemoryStats FrameMemoryGovernor::GetStats() const
+{
+    MemoryStats stats;
+    stats.bytes_in_flight = bytes_in_flight_.load(std::memory_order_relaxed);
+    stats.frames_in_flight = frames_in_flight_.load(std::memory_order_relaxed);
+    stats.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+    stats.pressure = pressure_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.budget_bytes = budget_bytes_;
+    stats.pressure_changes = pressure_changes_;
+    return stats;
+}
+
+void FrameMemoryGovernor::UpdatePressure()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Concurrent updates serialize here, the last one stores the level of the latest count
+    int64_t bytes = bytes_in_flight_.load(std::memory_order_relaxed);
+    MemoryPressure level = LevelFor(bytes);
+    if (pressure_.exchange(level, std::memory_order_relaxed) == level) {
+        return;
+    }
+    pressure_changes_++;
+    LOG_DEBUG("Frame memory pressure %d: %lld bytes in flight", static_cast<int>(level), static_cast<long long>(bytes));
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,116 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_FRAME_MEMORY_GOVERNOR_H
+#define LMSHAO_REMOTE_DESK_FRAME_MEMORY_GOVERNOR_H
+
+#include <coreutils/singleton.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace lmshao::remotedesk {
+
+using namespace lmshao::coreutils;
+
+/**
+ * @brief Frame memory pressure levels, ordered by severity
+ */
+enum class MemoryPressure {
+    NORMAL = 0,   // Below the high watermark
+    ELEVATED = 1, // Above the high watermark: sources should lower frame rate
+    CRITICAL = 2  // At or above the budget: sources should drop frames
+};
+
+/**
+ * @brief Process-wide accountant of the bytes held by in-flight Frames
+ * Every Frame reports its buffer capacity on construction, growth and
+ * destruction, so the count covers all pipelines of the process. With a
+ * budget set, sources poll GetPressure() for every frame and degrade
+ * gracefully instead of letting queues grow without bound. The accounting
+ * hot path is a relaxed atomic add; the mutex is only taken when an
+ * allocation or release moves the pressure to another level.
+ */
+class FrameMemoryGovernor : public Singleton<FrameMemoryGovernor> {
+    friend class Singleton<FrameMemoryGovernor>;
+
+public:
+    /**
+     * @brief Frame buffer accounting, called by Frame
+     */
+    static void TrackFrame(int64_t bytes_delta, int64_t frames_delta)
+    {
+        int64_t bytes = bytes_in_flight_.fetch_add(bytes_delta, std::memory_order_relaxed) + bytes_delta;
+        frames_in_flight_.fetch_add(frames_delta, std::memory_order_relaxed);
+
+        int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+        while (bytes > peak && !peak_bytes_.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+        }
+
+        if (LevelFor(bytes) != pressure_.load(std::memory_order_relaxed)) {
+            GetInstance()->UpdatePressure();
+        }
+    }
+
+    /**
+     * @brief Set the frame memory budget
+     * @param budget_bytes Bytes of in-flight frames allowed (0 = unlimited)
+     * @param high_watermark Fraction of the budget at which pressure becomes ELEVATED
+     */
+    void SetBudget(size_t budget_bytes, double high_watermark = 0.8);
+
+    MemoryPressure GetPressure() const { return pressure_.load(std::memory_order_relaxed); }
+
+    struct MemoryStats {
+        int64_t bytes_in_flight = 0;
+        int64_t frames_in_flight = 0;
+        int64_t peak_bytes = 0;
+        size_t budget_bytes = 0;
+        MemoryPressure pressure = MemoryPressure::NORMAL;
+        uint64_t pressure_changes = 0;
+    };
+    MemoryStats GetStats() const;
+
+protected:
+    FrameMemoryGovernor() = default;
+
+private:
+    /**
+     * @brief Pressure level for a byte count under the current budget, lock free
+     */
+    static MemoryPressure LevelFor(int64_t bytes)
+    {
+        if (bytes >= budget_limit_.load(std::memory_order_relaxed)) {
+            return MemoryPressure::CRITICAL;
+        }
+        return bytes >= high_watermark_.load(std::memory_order_relaxed) ? MemoryPressure::ELEVATED
+                                                                        : MemoryPressure::NORMAL;
+    }
+
+    /**
+     * @brief Store the pressure level of the bytes now in flight and count the change
+     */
+    void UpdatePressure();
+
+private:
+    static inline std::atomic<int64_t> bytes_in_flight_{0};
+    static inline std::atomic<int64_t> frames_in_flight_{0};
+    static inline std::atomic<int64_t> peak_bytes_{0};
+    static inline std::atomic<int64_t> high_watermark_{INT64_MAX};
+    static inline std::atomic<int64_t> budget_limit_{INT64_MAX}; // budget_bytes_, INT64_MAX when unlimited
+    static inline std::atomic<MemoryPressure> pressure_{MemoryPressure::NORMAL};
+
+    mutable std::mutex mutex_;
+    size_t budget_bytes_ = 0;
+    uint64_t pressure_changes_ = 0;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_FRAME_MEMORY_GOVERNOR_H
@@ -0,0 +1,251 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "frame_tracer.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../log/remote_desk_log.h"
+#include "type_name.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+thread_local std::shared_ptr<FrameTracer::ThreadBuffer> t_trace_buffer;
+
+const char *GetCategoryName(TraceCategory category)
+{
+    switch (category) {
+        case TraceCategory::CAPTURE:
+            return "capture";
+        case TraceCategory::PROCESS:
+            return "process";
+        case TraceCategory::QUEUE:
+            return "queue";
+        case TraceCategory::ENCODE:
+            return "encode";
+        case TraceCategory::PACKETIZE:
+            return "packetize";
+        case TraceCategory::SEND:
+            return "send";
+        default:
+            return "other";
+    }
+}
+
+// PROCESS spans are named with typeid(...).name(), demangled only when exported
+std::string GetEventName(const FrameTracer::TraceEvent &event)
+{
+    return event.category == TraceCategory::PROCESS ? GetTypeName(event.name) : std::string(event.name);
+}
+
+void AppendJsonString(std::string &out, const std::string &value)
+{
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+uint64_t GetCurrentThreadId()
+{
+#ifdef __linux__
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+    return std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+}
+
+uint64_t GetCurrentProcessId()
+{
+#ifdef __linux__
+    return static_cast<uint64_t>(getpid());
+#else
+    return 1;
+#endif
+}
+
+std::string GetCurrentThreadName()
+{
+#ifdef __linux__
+    char name[16] = {};
+    if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) {
+        return name;
+    }
+#endif
+    return {};
+}
+
+} // namespace
+
+void FrameTracer::Start(size_t spans_per_thread)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.clear();
+        spans_per_thread_ = std::max<size_t>(spans_per_thread, 1);
+        origin_ns_ = Now();
+        // Threads still holding a buffer of the previous recording replace it on their next span
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+    LOG_INFO("Frame tracing started, %zu spans per thread", spans_per_thread);
+}
+
+void FrameTracer::Stop()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+    auto stats = GetStats();
+    if (stats.dropped > 0) {
+        LOG_WARN("Frame tracing stopped: %" PRIu64 " spans on %zu threads, %" PRIu64
+                 " dropped (spans_per_thread too small)",
+                 stats.spans, stats.threads, stats.dropped);
+    } else {
+        LOG_INFO("Frame tracing stopped: %" PRIu64 " spans on %zu threads", stats.spans, stats.threads);
+    }
+}
+
+FrameTracer::ThreadBuffer *FrameTracer::GetThreadBuffer()
+{
+    uint64_t generation = generation_.load(std::memory_order_relaxed);
+    if (t_trace_buffer && t_trace_buffer->generation == generation) {
+        return t_trace_buffer.get();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    auto buffer = std::make_shared<ThreadBuffer>(spans_per_thread_);
+    buffer->generation = generation_.load(std::memory_order_relaxed);
+    buffer->thread_id = GetCurrentThreadId();
+    buffer->thread_name = GetCurrentThreadName();
+    buffers_.push_back(buffer);
+    t_trace_buffer = buffer;
+    return buffer.get();
+}
+
+void FrameTracer::Record(const char *name, TraceCategory category, int64_t frame, int64_t begin_ns, int64_t end_ns)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    ThreadBuffer *buffer = GetInstance()->GetThreadBuffer();
+    if (!buffer) {
+        return;
+    }
+
+    // Single writer: the slot is filled before the release store makes it visible to the exporter
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= buffer->events.size()) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = TraceEvent{name, frame, begin_ns, end_ns - begin_ns, category};
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+std::string FrameTracer::ExportChromeTrace() const
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int64_t origin_ns;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers = buffers_;
+        origin_ns = origin_ns_;
+    }
+
+    const uint64_t pid = GetCurrentProcessId();
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[160];
+    for (const auto &buffer : buffers) {
+        if (!buffer->thread_name.empty()) {
+            std::snprintf(number, sizeof(number),
+                          "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%" PRIu64 ",\"tid\":%" PRIu64
+                          ",\"args\":{\"name\":",
+                          first ? "" : ",", pid, buffer->thread_id);
+            out += number;
+            AppendJsonString(out, buffer->thread_name);
+            out += "}}";
+            first = false;
+        }
+
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent &event = buffer->events[i];
+            out += first ? "{\"name\":" : ",{\"name\":";
+            first = false;
+            AppendJsonString(out, GetEventName(event));
+            std::snprintf(number, sizeof(number),
+                          ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%" PRIu64 ",\"tid\":%" PRIu64,
+                          GetCategoryName(event.category), static_cast<double>(event.begin_ns - origin_ns) / 1000.0,
+                          static_cast<double>(event.duration_ns) / 1000.0, pid, buffer->thread_id);
+            out += number;
+            if (event.frame != NO_FRAME) {
+                std::snprintf(number, sizeof(number), ",\"args\":{\"frame\":%" PRId64 "}", event.frame);
+                out += number;
+            }
+            out += '}';
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool FrameTracer::WriteChromeTrace(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        LOG_ERROR("Failed to open trace file %s", path.c_str());
+        return false;
+    }
+    file << ExportChromeTrace();
+    if (!file.flush()) {
+        LOG_ERROR("Failed to write trace file %s", path.c_str());
+        return false;
+    }
+    LOG_INFO("Frame trace written to %s", path.c_str());
+    return true;
+}
+
+FrameTracer::TraceStats FrameTracer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    TraceStats stats;
+    stats.threads = buffers_.size();
+    for (const auto &buffer : buffers_) {
+        stats.spans += buffer->count.load(std::memory_order_acquire);
+        stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+} // namespace lmshao::remotedesk
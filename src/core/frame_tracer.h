@@ -0,0 +1,163 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_FRAME_TRACER_H
+#define LMSHAO_REMOTE_DESK_FRAME_TRACER_H
+
+#include <coreutils/singleton.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+using namespace lmshao::coreutils;
+
+/**
+ * @brief Pipeline step a trace span belongs to, exported as the Chrome trace category
+ */
+enum class TraceCategory : uint8_t {
+    CAPTURE = 0,
+    PROCESS = 1, // A sink's OnFrame, named after the sink's class
+    QUEUE = 2,   // Waiting in a queue between two threads
+    ENCODE = 3,
+    PACKETIZE = 4,
+    SEND = 5,
+};
+
+/**
+ * @brief Records frame lifecycle spans and exports them as Chrome trace JSON
+ * Every thread appends complete spans (name, category, frame timestamp,
+ * begin and duration) to a buffer of its own, so recording takes no lock: one
+ * release store publishes the span to the exporter. Buffers have a fixed
+ * size, spans past it are counted and dropped. Frames are identified by their
+ * capture timestamp, which every stage carries forward. The export opens in
+ * chrome://tracing or ui.perfetto.dev, with one track per thread.
+ */
+class FrameTracer : public Singleton<FrameTracer> {
+    friend class Singleton<FrameTracer>;
+
+public:
+    static constexpr int64_t NO_FRAME = -1;
+
+    static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Start a new recording, spans of the previous one are discarded
+     * @param spans_per_thread Buffer size of each recording thread
+     */
+    void Start(size_t spans_per_thread = 65536);
+    void Stop();
+
+    /**
+     * @brief Spans recorded so far as Chrome trace JSON (recording may continue)
+     */
+    std::string ExportChromeTrace() const;
+    bool WriteChromeTrace(const std::string &path) const;
+
+    struct TraceStats {
+        uint64_t spans = 0;
+        uint64_t dropped = 0; // Buffer of the recording thread was full
+        size_t threads = 0;
+    };
+    TraceStats GetStats() const;
+
+    /**
+     * @brief Nanoseconds on the tracer clock, for spans timed by the caller
+     */
+    static int64_t Now()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    }
+
+    /**
+     * @brief Record a span timed by the caller, e.g. a queue wait measured on another thread
+     * @param name Must outlive the recording, typically a string literal
+     */
+    static void Record(const char *name, TraceCategory category, int64_t frame, int64_t begin_ns, int64_t end_ns);
+
+    /**
+     * @brief Records the lifetime of the scope as a span on the calling thread
+     */
+    class Span {
+    public:
+        Span(const char *name, TraceCategory category, int64_t frame = NO_FRAME)
+        {
+            if (IsEnabled()) {
+                name_ = name;
+                category_ = category;
+                frame_ = frame;
+                begin_ = Now();
+            }
+        }
+        ~Span()
+        {
+            if (name_) {
+                Record(name_, category_, frame_, begin_, Now());
+            }
+        }
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *name_ = nullptr;
+        TraceCategory category_ = TraceCategory::PROCESS;
+        int64_t frame_ = NO_FRAME;
+        int64_t begin_ = 0;
+    };
+
+    struct TraceEvent {
+        const char *name;
+        int64_t frame;
+        int64_t begin_ns;
+        int64_t duration_ns;
+        TraceCategory category;
+    };
+
+    /**
+     * @brief Spans of one thread, appended only by that thread
+     */
+    struct ThreadBuffer {
+        explicit ThreadBuffer(size_t capacity) : events(capacity) {}
+
+        std::vector<TraceEvent> events;
+        std::atomic<size_t> count{0};
+        std::atomic<uint64_t> dropped{0};
+        uint64_t generation = 0;
+        uint64_t thread_id = 0;
+        std::string thread_name;
+    };
+
+protected:
+    FrameTracer() = default;
+
+private:
+    /**
+     * @brief Buffer of the calling thread for the current recording, nullptr once stopped
+     */
+    ThreadBuffer *GetThreadBuffer();
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::atomic<uint64_t> generation_{0};
+
+    mutable std::mutex mutex_; // Guards buffers_, taken once per thread and recording, not per span
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    size_t spans_per_thread_ = 65536;
+    int64_t origin_ns_ = 0;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_FRAME_TRACER_H
@@ -12,6 +12,7 @@
 #include <mutex>
 
 #include "pipeline_interfaces.h"
+#include "stage_counters.h"
 
 namespace lmshao::remotedesk {
 
@@ -21,7 +22,7 @@ namespace lmshao::remotedesk {
 class MediaProcessor : public ISource, public ISink {
 public:
     MediaProcessor() = default;
-    ~MediaProcessor() override = default;
+    ~MediaProcessor() override { StageCounters::GetInstance()->ForgetStage(MediaProcessor::GetId()); }
 
     // Lifecycle management - Processors are passive and data-driven
     // They only need initialization, no active start/stop required
@@ -42,9 +43,16 @@ public:
     // INode implementation
     uint64_t GetId() const override { return reinterpret_cast<uint64_t>(this); }
 
+    // Hardware counters of this processor's OnFrame, empty unless StageCounters is enabled
+    StageCounterStats GetCounterStats() const { return StageCounters::GetInstance()->GetStats(GetId()); }
+
     // ISink implementation (input connector)
     // Pure virtual - derived classes must implement their processing logic
-    void OnFrame(std::shared_ptr<Frame> frame) override = 0;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override = 0;
+
+    // Frames meant for this processor were dropped upstream, so the dirty rectangles of the next frame
+    // miss their changes. Called before that frame's OnFrame, on the thread delivering it.
+    virtual void OnFramesDropped() {}
 };
 
 } // namespace lmshao::remotedesk
@@ -27,7 +27,7 @@ public:
     uint64_t GetId() const override { return reinterpret_cast<uint64_t>(this); }
 
     // ISink implementation (pure virtual - derived classes must implement)
-    void OnFrame(std::shared_ptr<Frame> frame) override = 0;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override = 0;
 };
 
 } // namespace lmshao::remotedesk
@@ -11,8 +11,11 @@
 #include <algorithm>
 #include <cinttypes>
 #include <mutex>
+#include <typeinfo>
 
 #include "../log/remote_desk_log.h"
+#include "frame_tracer.h"
+#include "stage_counters.h"
 
 namespace lmshao::remotedesk {
 void ISource::AddSink(std::shared_ptr<ISink> sink)
@@ -63,7 +66,7 @@ bool ISource::HasSinks() const
     return !sinks_.empty();
 }
 
-void ISource::DeliverFrame(std::shared_ptr<Frame> frame)
+void ISource::DeliverFrame(const std::shared_ptr<Frame> &frame)
 {
     if (!frame || !frame->IsValid()) {
         return;
@@ -72,6 +75,8 @@ void ISource::DeliverFrame(std::shared_ptr<Frame> frame)
     std::shared_lock<std::shared_mutex> lock(sinks_mutex_);
     for (auto &sink : sinks_) {
         if (sink) {
+            FrameTracer::Span span(typeid(*sink).name(), TraceCategory::PROCESS, frame->timestamp);
+            StageCounters::Scope counters(sink->GetId());
             sink->OnFrame(frame);
         }
     }
@@ -38,7 +38,7 @@ public:
     bool HasSinks() const;
 
 protected:
-    void DeliverFrame(std::shared_ptr<Frame> frame);
+    void DeliverFrame(const std::shared_ptr<Frame> &frame);
 
 private:
     std::vector<std::shared_ptr<ISink>> sinks_;
@@ -49,7 +49,8 @@ class ISink : public virtual INode {
 public:
     virtual ~ISink() = default;
 
-    virtual void OnFrame(std::shared_ptr<Frame> frame) = 0;
+    // The reference is only valid during the call, sinks that keep the frame copy the pointer
+    virtual void OnFrame(const std::shared_ptr<Frame> &frame) = 0;
 };
 
 } // namespace lmshao::remotedesk
@@ -0,0 +1,325 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "session_worker_pool.h"
+
+#include <algorithm>
+#include <ctime>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+SessionWorkerPool::SessionWorkerPool(const SessionWorkerPoolConfig &config) : config_(config)
+{
+    if (config_.budget_window.count() <= 0) {
+        config_.budget_window = std::chrono::milliseconds(1000);
+    }
+}
+
+SessionWorkerPool::~SessionWorkerPool()
+{
+    Stop();
+}
+
+bool SessionWorkerPool::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+
+    size_t threads = config_.thread_count > 0 ? config_.thread_count : std::thread::hardware_concurrency();
+    threads = std::max<size_t>(1, threads);
+
+    running_ = true;
+    window_start_ = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&SessionWorkerPool::WorkerThreadProc, this);
+    }
+
+    LOG_DEBUG("Session worker pool started with %zu threads", threads);
+    return true;
+}
+
+void SessionWorkerPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    workers_.clear();
+    retired_workers_ = 0;
+    abandoned_workers_ = 0;
+    for (auto &session : order_) {
+        session->queue.clear();
+        session->queued_bytes = 0;
+    }
+    queued_bytes_ = 0;
+    LOG_DEBUG("Session worker pool stopped");
+}
+
+void SessionWorkerPool::AddSession(const std::string &session_id, double cpu_budget_cores)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sessions_.count(session_id)) {
+        sessions_[session_id]->cpu_budget_cores = cpu_budget_cores;
+        return;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->id = session_id;
+    session->cpu_budget_cores = cpu_budget_cores;
+    sessions_[session_id] = session;
+    order_.push_back(session);
+}
+
+void SessionWorkerPool::RemoveSession(const std::string &session_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return;
+    }
+
+    queued_bytes_ -= it->second->queued_bytes;
+    it->second->queue.clear();
+    it->second->queued_bytes = 0;
+    if (it->second->running && running_) {
+        // The task may never return: keep the pool at full strength without its worker
+        it->second->removed = true;
+        abandoned_workers_++;
+        retired_workers_++;
+        workers_replaced_++;
+        workers_.emplace_back(&SessionWorkerPool::WorkerThreadProc, this);
+        LOG_WARN("Session %s removed while running, replacing its worker", session_id.c_str());
+    }
+    order_.erase(std::remove(order_.begin(), order_.end(), it->second), order_.end());
+    sessions_.erase(it);
+    if (cursor_ >= order_.size()) {
+        cursor_ = 0;
+    }
+}
+
+void SessionWorkerPool::SetSessionBudget(const std::string &session_id, double cpu_budget_cores)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second->cpu_budget_cores = cpu_budget_cores;
+    }
+    cv_.notify_all();
+}
+
+bool SessionWorkerPool::Submit(const std::string &session_id, Task task, const std::shared_ptr<Frame> &frame,
+                               uint64_t stream_id)
+{
+    size_t bytes = frame ? frame->Size() : 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        auto it = sessions_.find(session_id);
+        if (it == sessions_.end()) {
+            return false;
+        }
+
+        Session &session = *it->second;
+        if (config_.max_tasks_per_session > 0 && session.queue.size() >= config_.max_tasks_per_session) {
+            DropFrontLocked(session);
+        }
+        while (queued_bytes_ + bytes > config_.max_queued_bytes && DropOldestLocked()) {
+        }
+
+        session.queue.push_back({std::move(task), frame, stream_id, bytes});
+        session.queued_bytes += bytes;
+        queued_bytes_ += bytes;
+    }
+    cv_.notify_one();
+    return true;
+}
+
+SessionWorkerPool::SessionStats SessionWorkerPool::GetSessionStats(const std::string &session_id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return {};
+    }
+
+    SessionStats stats = it->second->stats;
+    stats.queued_tasks = it->second->queue.size();
+    stats.queued_bytes = it->second->queued_bytes;
+    return stats;
+}
+
+SessionWorkerPool::PoolStats SessionWorkerPool::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    PoolStats stats;
+    stats.sessions = sessions_.size();
+    stats.threads = workers_.size() - retired_workers_;
+    stats.abandoned_workers = abandoned_workers_;
+    stats.workers_replaced = workers_replaced_;
+    stats.queued_bytes = queued_bytes_;
+    stats.tasks_dropped = tasks_dropped_;
+    return stats;
+}
+
+void SessionWorkerPool::WorkerThreadProc()
+{
+    ApplyThreadScheduling(config_.thread_scheduling, "session worker");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        RollBudgetWindowLocked(std::chrono::steady_clock::now());
+
+        auto session = PickSessionLocked();
+        if (!session) {
+            // Nothing runnable: wait for new work, or for the window that lifts the budget limits
+            cv_.wait_until(lock, window_start_ + config_.budget_window);
+            continue;
+        }
+
+        QueuedTask task = std::move(session->queue.front());
+        session->queue.pop_front();
+        session->queued_bytes -= task.bytes;
+        queued_bytes_ -= task.bytes;
+        session->running = true;
+
+        // The rectangles of the dropped frames are not included in this one
+        bool damage_lost = task.frame && session->damage_lost_streams.erase(task.stream_id) > 0;
+
+        lock.unlock();
+        auto cpu_start = ThreadCpuTime();
+        task.task(damage_lost);
+        auto cpu_used = ThreadCpuTime() - cpu_start;
+        lock.lock();
+
+        if (session->removed) {
+            // A replacement took this worker's place
+            abandoned_workers_--;
+            return;
+        }
+        session->running = false;
+        session->cpu_used_in_window += cpu_used;
+        session->stats.tasks_run++;
+        if (!session->queue.empty()) {
+            cv_.notify_one();
+        }
+    }
+}
+
+std::shared_ptr<SessionWorkerPool::Session> SessionWorkerPool::PickSessionLocked()
+{
+    const auto window = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.budget_window);
+
+    for (size_t i = 0; i < order_.size(); ++i) {
+        size_t index = (cursor_ + i) % order_.size();
+        auto &session = order_[index];
+        if (session->running || session->queue.empty()) {
+            continue;
+        }
+
+        if (session->cpu_budget_cores > 0.0 && session->cpu_used_in_window.count() >=
+                                                   static_cast<int64_t>(session->cpu_budget_cores * window.count())) {
+            session->stats.budget_deferrals++;
+            continue;
+        }
+
+        cursor_ = (index + 1) % order_.size();
+        return session;
+    }
+    return nullptr;
+}
+
+void SessionWorkerPool::RollBudgetWindowLocked(std::chrono::steady_clock::time_point now)
+{
+    if (now - window_start_ < config_.budget_window) {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - window_start_);
+    for (auto &session : order_) {
+        session->stats.cpu_cores =
+            static_cast<double>(session->cpu_used_in_window.count()) / static_cast<double>(elapsed.count());
+        session->cpu_used_in_window = std::chrono::nanoseconds(0);
+    }
+    window_start_ = now;
+    cv_.notify_all();
+}
+
+bool SessionWorkerPool::DropOldestLocked()
+{
+    std::shared_ptr<Session> victim;
+    for (auto &session : order_) {
+        if (!session->queue.empty() && (!victim || session->queued_bytes > victim->queued_bytes)) {
+            victim = session;
+        }
+    }
+    if (!victim) {
+        return false;
+    }
+    DropFrontLocked(*victim);
+    return true;
+}
+
+void SessionWorkerPool::DropFrontLocked(Session &session)
+{
+    if (session.queue.empty()) {
+        return;
+    }
+    const QueuedTask &task = session.queue.front();
+    size_t bytes = task.bytes;
+    if (task.frame) {
+        session.damage_lost_streams.insert(task.stream_id);
+    }
+    session.queue.pop_front();
+    session.queued_bytes -= bytes;
+    queued_bytes_ -= bytes;
+    session.stats.tasks_dropped++;
+    tasks_dropped_++;
+}
+
+std::chrono::nanoseconds SessionWorkerPool::ThreadCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return std::chrono::nanoseconds(0);
+    }
+    ULARGE_INTEGER kernel_time{{kernel.dwLowDateTime, kernel.dwHighDateTime}};
+    ULARGE_INTEGER user_time{{user.dwLowDateTime, user.dwHighDateTime}};
+    return std::chrono::nanoseconds((kernel_time.QuadPart + user_time.QuadPart) * 100); // 100 ns units
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#endif
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,186 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_SESSION_WORKER_POOL_H
+#define LMSHAO_REMOTE_DESK_SESSION_WORKER_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame.h"
+#include "thread_scheduling.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Session worker pool configuration
+ */
+struct SessionWorkerPoolConfig {
+    uint32_t thread_count = 0;                      // Worker threads (0 = hardware concurrency)
+    size_t max_tasks_per_session = 4;               // Older tasks are dropped beyond this depth
+    size_t max_queued_bytes = 256 * 1024 * 1024;    // Frame bytes queued across all sessions
+    std::chrono::milliseconds budget_window{1000};  // Accounting window of the CPU budgets
+    ThreadSchedulingConfig thread_scheduling;       // Applied to every worker, which runs the converters and encoders
+};
+
+/**
+ * @brief Worker threads shared by the pipelines of many sessions
+ * Each session owns a FIFO of tasks. Tasks of one session run one at a time
+ * and in order, because pipeline stages such as encoders are stateful;
+ * tasks of different sessions run in parallel. Workers pick sessions round
+ * robin, so a busy desktop cannot starve a quiet one. A session whose tasks
+ * used more CPU time than its budget in the current window is skipped until
+ * the window ends. Queues are bounded per session and by total frame bytes;
+ * the oldest task is dropped first, since a stale frame is worth least.
+ * Dropping a frame task loses its dirty rectangles, so the next task of the
+ * same stream is told that frames were lost and must treat its frame as
+ * fully changed. Queued frames are shared with other sinks and never modified.
+ * A session removed while one of its tasks runs, e.g. a stuck encoder, is
+ * detached: a replacement worker takes over the thread and the running one
+ * leaves the pool once its task returns, so a session can be restarted with
+ * RemoveSession and AddSession of the same id without losing a worker.
+ */
+class SessionWorkerPool {
+public:
+    // damage_lost: a frame task of the same stream was dropped since the previous one ran
+    using Task = std::function<void(bool damage_lost)>;
+
+    explicit SessionWorkerPool(const SessionWorkerPoolConfig &config = {});
+    ~SessionWorkerPool();
+
+    bool Start();
+    void Stop();
+
+    /**
+     * @brief Register a session
+     * @param cpu_budget_cores CPU time per wall-clock time the session may use, e.g. 1.5 cores (0 = unlimited)
+     */
+    void AddSession(const std::string &session_id, double cpu_budget_cores = 0.0);
+
+    /**
+     * @brief Unregister a session and drop its queued tasks
+     * A running task completes on a worker that is replaced and retires afterwards.
+     */
+    void RemoveSession(const std::string &session_id);
+
+    /**
+     * @brief Change a session's CPU budget
+     */
+    void SetSessionBudget(const std::string &session_id, double cpu_budget_cores);
+
+    /**
+     * @brief Queue a task for a session
+     * @param frame Frame the task processes (may be nullptr), its size is counted against max_queued_bytes
+     * @param stream_id Identifies the stage the frame is queued for; lost frames are reported per stream
+     * @return false if the session is unknown or the pool is stopped
+     */
+    bool Submit(const std::string &session_id, Task task, const std::shared_ptr<Frame> &frame = nullptr,
+                uint64_t stream_id = 0);
+
+    struct SessionStats {
+        uint64_t tasks_run = 0;
+        uint64_t tasks_dropped = 0;
+        uint64_t budget_deferrals = 0; // Times the session was skipped for exceeding its budget
+        size_t queued_tasks = 0;
+        size_t queued_bytes = 0;
+        double cpu_cores = 0.0; // CPU use in the last complete window
+    };
+    SessionStats GetSessionStats(const std::string &session_id) const;
+
+    struct PoolStats {
+        size_t sessions = 0;
+        size_t threads = 0;           // Workers taking tasks
+        size_t abandoned_workers = 0; // Workers still running a task of a removed session
+        uint64_t workers_replaced = 0;
+        size_t queued_bytes = 0;
+        uint64_t tasks_dropped = 0;
+    };
+    PoolStats GetStats() const;
+
+private:
+    struct QueuedTask {
+        Task task;
+        std::shared_ptr<Frame> frame;
+        uint64_t stream_id = 0;
+        size_t bytes = 0;
+    };
+
+    struct Session {
+        std::string id;
+        std::deque<QueuedTask> queue;
+        size_t queued_bytes = 0;
+        std::set<uint64_t> damage_lost_streams; // Streams whose next frame must be treated as fully changed
+        bool running = false;
+        bool removed = false; // Unregistered while running, its worker retires when the task returns
+        double cpu_budget_cores = 0.0;
+        std::chrono::nanoseconds cpu_used_in_window{0};
+        SessionStats stats;
+    };
+
+    /**
+     * @brief Worker thread main function
+     */
+    void WorkerThreadProc();
+
+    /**
+     * @brief Pick the next runnable session in round robin order (mutex_ held)
+     * @return nullptr if none is runnable now
+     */
+    std::shared_ptr<Session> PickSessionLocked();
+
+    /**
+     * @brief Start a new budget window when the current one has elapsed (mutex_ held)
+     */
+    void RollBudgetWindowLocked(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Drop the oldest task of the session holding the most queued bytes (mutex_ held)
+     */
+    bool DropOldestLocked();
+
+    /**
+     * @brief Drop the oldest task of a session (mutex_ held)
+     */
+    void DropFrontLocked(Session &session);
+
+    /**
+     * @brief CPU time consumed by the calling thread
+     */
+    static std::chrono::nanoseconds ThreadCpuTime();
+
+private:
+    SessionWorkerPoolConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::vector<std::thread> workers_;
+    size_t retired_workers_ = 0;   // Threads in workers_ abandoned or exited, joined by Stop
+    size_t abandoned_workers_ = 0; // Retired threads still running their task
+    uint64_t workers_replaced_ = 0;
+
+    std::map<std::string, std::shared_ptr<Session>> sessions_;
+    std::vector<std::shared_ptr<Session>> order_; // Round robin order
+    size_t cursor_ = 0;
+    size_t queued_bytes_ = 0;
+    uint64_t tasks_dropped_ = 0;
+    std::chrono::steady_clock::time_point window_start_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_SESSION_WORKER_POOL_H
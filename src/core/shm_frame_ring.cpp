@@ -0,0 +1,351 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifdef __linux__
+
+#include "shm_frame_ring.h"
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "../log/remote_desk_log.h"
+#include "thread_scheduling.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+constexpr uint32_t RING_MAGIC = 0x52444652; // "RDFR"
+constexpr uint32_t RING_VERSION = 1;
+constexpr size_t PAGE_SIZE_BYTES = 4096;
+constexpr size_t META_SIZE = 64; // Keeps slot data cache line aligned
+constexpr uint32_t MAX_SLOT_COUNT = 64;
+
+static_assert(sizeof(ShmFrameMeta) <= META_SIZE, "ShmFrameMeta must fit in its reserved space");
+
+size_t RoundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+// Lives at offset 0 of the shared mapping, indices sit on their own cache lines
+struct ShmFrameRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t reserved;
+    uint64_t slot_size;
+    uint64_t slot_stride;
+    alignas(64) std::atomic<uint64_t> write_index;
+    alignas(64) std::atomic<uint64_t> read_index;
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+              "Ring indices must be lock-free to be shared between processes");
+
+void ShmFrameSlotView::SetMeta(const Frame &frame)
+{
+    meta->timestamp = frame.timestamp;
+    meta->format = static_cast<int32_t>(frame.format);
+    meta->stride = frame.stride;
+    meta->size = frame.Size();
+    if (frame.IsVideo()) {
+        meta->width = frame.video_info.width;
+        meta->height = frame.video_info.height;
+        meta->framerate = frame.video_info.framerate;
+        meta->is_keyframe = frame.video_info.is_keyframe ? 1 : 0;
+        meta->temporal_id = frame.video_info.temporal_id;
+        meta->long_term_reference = frame.video_info.long_term_reference ? 1 : 0;
+    }
+}
+
+ShmFrameMeta ShmFrameSlotView::ReadMeta() const
+{
+    ShmFrameMeta copy;
+    memcpy(&copy, meta, sizeof(copy));
+    return copy;
+}
+
+void ShmFrameMeta::CopyTo(Frame &frame) const
+{
+    frame.timestamp = timestamp;
+    frame.format = static_cast<FrameFormat>(format);
+    frame.stride = stride;
+    if (frame.IsVideo()) {
+        frame.video_info.width = width;
+        frame.video_info.height = height;
+        frame.video_info.framerate = framerate;
+        frame.video_info.is_keyframe = is_keyframe != 0;
+        frame.video_info.temporal_id = temporal_id;
+        frame.video_info.long_term_reference = long_term_reference != 0;
+    }
+}
+
+ShmFrameRing::~ShmFrameRing()
+{
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+    }
+    if (memory_fd_ >= 0) {
+        close(memory_fd_);
+    }
+}
+
+std::unique_ptr<ShmFrameRing> ShmFrameRing::Create(uint32_t slot_count, size_t slot_size)
+{
+    if (slot_count < 2 || slot_count > MAX_SLOT_COUNT || slot_size == 0) {
+        LOG_ERROR("Invalid shared frame ring geometry: %u slots of %zu bytes", slot_count, slot_size);
+        return nullptr;
+    }
+
+    std::unique_ptr<ShmFrameRing> ring(new ShmFrameRing());
+    ring->slot_count_ = slot_count;
+    ring->slot_size_ = slot_size;
+    ring->slot_stride_ = RoundUp(META_SIZE + slot_size, PAGE_SIZE_BYTES);
+    size_t mapping_size = PAGE_SIZE_BYTES + ring->slot_stride_ * slot_count;
+
+    ring->memory_fd_ = memfd_create("remote-desk-frames", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (ring->memory_fd_ < 0) {
+        LOG_ERROR("memfd_create failed: %s", strerror(errno));
+        return nullptr;
+    }
+    if (ftruncate(ring->memory_fd_, static_cast<off_t>(mapping_size)) != 0) {
+        LOG_ERROR("Failed to size shared frame ring to %zu bytes: %s", mapping_size, strerror(errno));
+        return nullptr;
+    }
+    // The consumer maps the whole file, it must not be able to shrink under it
+    if (fcntl(ring->memory_fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        LOG_ERROR("Failed to seal shared frame ring: %s", strerror(errno));
+        return nullptr;
+    }
+
+    ring->event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (ring->event_fd_ < 0) {
+        LOG_ERROR("eventfd failed: %s", strerror(errno));
+        return nullptr;
+    }
+
+    if (!ring->Map(mapping_size)) {
+        return nullptr;
+    }
+
+    Header *header = ring->header_;
+    header->magic = RING_MAGIC;
+    header->version = RING_VERSION;
+    header->slot_count = slot_count;
+    header->slot_size = slot_size;
+    header->slot_stride = ring->slot_stride_;
+    header->write_index.store(0, std::memory_order_relaxed);
+    header->read_index.store(0, std::memory_order_release);
+
+    LOG_DEBUG("Shared frame ring created: %u slots of %zu bytes (%zu bytes mapped)", slot_count, slot_size,
+              mapping_size);
+    return ring;
+}
+
+std::unique_ptr<ShmFrameRing> ShmFrameRing::Attach(int memory_fd, int event_fd)
+{
+    std::unique_ptr<ShmFrameRing> ring(new ShmFrameRing());
+    ring->memory_fd_ = memory_fd;
+    ring->event_fd_ = event_fd;
+
+    int seals = fcntl(memory_fd, F_GET_SEALS);
+    if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+        LOG_ERROR("Shared frame ring memory is not sealed against shrinking");
+        return nullptr;
+    }
+
+    struct stat st {};
+    if (fstat(memory_fd, &st) != 0 || static_cast<size_t>(st.st_size) < PAGE_SIZE_BYTES) {
+        LOG_ERROR("Shared frame ring memory is too small");
+        return nullptr;
+    }
+
+    size_t mapping_size = static_cast<size_t>(st.st_size);
+    if (!ring->Map(mapping_size)) {
+        return nullptr;
+    }
+
+    const Header *header = ring->header_;
+    if (header->magic != RING_MAGIC || header->version != RING_VERSION) {
+        LOG_ERROR("Shared frame ring has unexpected magic %08x / version %u", header->magic, header->version);
+        return nullptr;
+    }
+
+    // Geometry comes from the other process: check it against the sealed size before trusting it
+    if (header->slot_count < 2 || header->slot_count > MAX_SLOT_COUNT || header->slot_size == 0 ||
+        header->slot_stride < META_SIZE + header->slot_size ||
+        PAGE_SIZE_BYTES + header->slot_stride * header->slot_count > mapping_size) {
+        LOG_ERROR("Shared frame ring geometry does not match its %zu byte mapping", mapping_size);
+        return nullptr;
+    }
+
+    ring->slot_count_ = header->slot_count;
+    ring->slot_size_ = header->slot_size;
+    ring->slot_stride_ = header->slot_stride;
+
+    LOG_DEBUG("Attached shared frame ring: %u slots of %zu bytes", ring->slot_count_, ring->slot_size_);
+    return ring;
+}
+
+bool ShmFrameRing::LockMemory()
+{
+    return LockMemoryRange(mapping_, mapping_size_, "shared frame ring");
+}
+
+bool ShmFrameRing::Map(size_t mapping_size)
+{
+    void *mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd_, 0);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Failed to map shared frame ring: %s", strerror(errno));
+        return false;
+    }
+
+    mapping_ = static_cast<uint8_t *>(mapping);
+    mapping_size_ = mapping_size;
+    header_ = reinterpret_cast<Header *>(mapping_);
+    return true;
+}
+
+bool ShmFrameRing::SendDescriptors(int socket_fd, int memory_fd, int event_fd)
+{
+    int fds[2] = {memory_fd, event_fd};
+    char control[CMSG_SPACE(sizeof(fds))] = {};
+    char marker = 'F';
+
+    iovec iov{&marker, 1};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(socket_fd, &msg, MSG_NOSIGNAL) != 1) {
+        LOG_ERROR("Failed to send shared frame ring descriptors: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool ShmFrameRing::ReceiveDescriptors(int socket_fd, int &memory_fd, int &event_fd)
+{
+    int fds[2] = {-1, -1};
+    char control[CMSG_SPACE(sizeof(fds))] = {};
+    char marker = 0;
+
+    iovec iov{&marker, 1};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC);
+    if (received != 1) {
+        LOG_ERROR("Failed to receive shared frame ring descriptors: %s", received < 0 ? strerror(errno) : "closed");
+        return false;
+    }
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(fds)) || (msg.msg_flags & MSG_CTRUNC)) {
+        LOG_ERROR("Shared frame ring handshake carried no descriptors");
+        return false;
+    }
+
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    memory_fd = fds[0];
+    event_fd = fds[1];
+    return true;
+}
+
+ShmFrameSlotView ShmFrameRing::GetSlot(uint64_t index)
+{
+    uint8_t *slot = mapping_ + PAGE_SIZE_BYTES + slot_stride_ * (index % slot_count_);
+
+    ShmFrameSlotView view;
+    view.meta = reinterpret_cast<ShmFrameMeta *>(slot);
+    view.data = slot + META_SIZE;
+    view.capacity = slot_size_;
+    return view;
+}
+
+ShmFrameSlotView ShmFrameRing::AcquireWriteSlot()
+{
+    uint64_t write_index = header_->write_index.load(std::memory_order_relaxed);
+    uint64_t read_index = header_->read_index.load(std::memory_order_acquire);
+    if (write_index - read_index >= slot_count_) {
+        return {};
+    }
+    return GetSlot(write_index);
+}
+
+void ShmFrameRing::CommitWriteSlot(uint64_t sequence)
+{
+    uint64_t write_index = header_->write_index.load(std::memory_order_relaxed);
+    GetSlot(write_index).meta->sequence = sequence;
+    header_->write_index.store(write_index + 1, std::memory_order_release);
+
+    uint64_t one = 1;
+    if (write(event_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        LOG_WARN("Failed to signal shared frame ring: %s", strerror(errno));
+    }
+}
+
+ShmFrameSlotView ShmFrameRing::PeekReadSlot()
+{
+    uint64_t read_index = header_->read_index.load(std::memory_order_relaxed);
+    uint64_t write_index = header_->write_index.load(std::memory_order_acquire);
+    if (read_index == write_index) {
+        return {};
+    }
+
+    return GetSlot(read_index);
+}
+
+void ShmFrameRing::ReleaseReadSlot()
+{
+    uint64_t read_index = header_->read_index.load(std::memory_order_relaxed);
+    header_->read_index.store(read_index + 1, std::memory_order_release);
+}
+
+void ShmFrameRing::Resync()
+{
+    header_->read_index.store(header_->write_index.load(std::memory_order_acquire), std::memory_order_release);
+    ConsumeNotification();
+}
+
+void ShmFrameRing::ConsumeNotification()
+{
+    uint64_t count = 0;
+    if (read(event_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        LOG_WARN("Failed to read shared frame ring notification: %s", strerror(errno));
+    }
+}
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
@@ -0,0 +1,174 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_SHM_FRAME_RING_H
+#define LMSHAO_REMOTE_DESK_SHM_FRAME_RING_H
+
+#ifdef __linux__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "frame.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Frame metadata stored in front of each slot's pixel data
+ * Plain fixed-width fields only: both processes map the same bytes.
+ */
+struct ShmFrameMeta {
+    uint64_t sequence = 0;
+    int64_t timestamp = 0;
+    int32_t format = 0;
+    uint32_t stride = 0;
+    uint64_t size = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    uint32_t framerate = 0;
+    uint8_t is_keyframe = 0;
+    uint8_t temporal_id = 0;
+    uint8_t long_term_reference = 0;
+
+    /**
+     * @brief Restore the header fields of a frame (pixels are not touched)
+     */
+    void CopyTo(Frame &frame) const;
+};
+
+/**
+ * @brief One slot of the ring as seen by the calling process
+ */
+struct ShmFrameSlotView {
+    ShmFrameMeta *meta = nullptr;
+    uint8_t *data = nullptr;
+    size_t capacity = 0;
+
+    explicit operator bool() const { return meta != nullptr; }
+
+    /**
+     * @brief Copy the header fields of a frame into the slot metadata (pixels are not touched)
+     */
+    void SetMeta(const Frame &frame);
+
+    /**
+     * @brief Snapshot of the slot metadata
+     * The other process can rewrite the slot at any time; a consumer validates
+     * this copy and uses nothing else, never the fields in shared memory.
+     */
+    ShmFrameMeta ReadMeta() const;
+};
+
+/**
+ * @brief Single-producer single-consumer ring of frame slots in memfd shared memory
+ * The producer creates the ring and hands its memfd and eventfd to the consumer
+ * over a Unix domain socket (SCM_RIGHTS). Slots are written in place and
+ * published by advancing the write index; the consumer reads them in place and
+ * frees them by advancing the read index. The eventfd wakes the consumer after
+ * each publish. A full ring never blocks the producer, the frame is dropped.
+ */
+class ShmFrameRing {
+public:
+    ~ShmFrameRing();
+
+    ShmFrameRing(const ShmFrameRing &) = delete;
+    ShmFrameRing &operator=(const ShmFrameRing &) = delete;
+
+    /**
+     * @brief Create a sealed memfd ring (producer side)
+     * @param slot_size Largest frame payload in bytes
+     * @return nullptr on failure
+     */
+    static std::unique_ptr<ShmFrameRing> Create(uint32_t slot_count, size_t slot_size);
+
+    /**
+     * @brief Map a ring received from the producer, taking ownership of both descriptors
+     * @return nullptr if the memory does not hold a valid ring
+     */
+    static std::unique_ptr<ShmFrameRing> Attach(int memory_fd, int event_fd);
+
+    /**
+     * @brief Send the ring descriptors over a connected Unix domain socket
+     */
+    static bool SendDescriptors(int socket_fd, int memory_fd, int event_fd);
+
+    /**
+     * @brief Receive ring descriptors sent with SendDescriptors
+     */
+    static bool ReceiveDescriptors(int socket_fd, int &memory_fd, int &event_fd);
+
+    // Producer side
+    /**
+     * @brief Next free slot, or an empty view if the consumer has not released any
+     */
+    ShmFrameSlotView AcquireWriteSlot();
+
+    /**
+     * @brief Publish the slot returned by AcquireWriteSlot and wake the consumer
+     * @param sequence Producer frame number, gaps tell the consumer how many frames were dropped
+     */
+    void CommitWriteSlot(uint64_t sequence);
+
+    // Consumer side
+    /**
+     * @brief Oldest published slot, or an empty view if the ring is empty
+     * The metadata is written by the producer and not validated.
+     */
+    ShmFrameSlotView PeekReadSlot();
+
+    /**
+     * @brief Hand the slot returned by PeekReadSlot back to the producer
+     */
+    void ReleaseReadSlot();
+
+    /**
+     * @brief Skip everything published so far (used when a consumer attaches)
+     */
+    void Resync();
+
+    /**
+     * @brief Reset the eventfd counter after a wakeup
+     */
+    void ConsumeNotification();
+
+    /**
+     * @brief Fault in and lock the whole mapping, so slot reads and writes never page fault
+     */
+    bool LockMemory();
+
+    int GetMemoryFd() const { return memory_fd_; }
+    int GetEventFd() const { return event_fd_; }
+    uint32_t GetSlotCount() const { return slot_count_; }
+    size_t GetSlotSize() const { return slot_size_; }
+
+private:
+    ShmFrameRing() = default;
+
+    bool Map(size_t mapping_size);
+    ShmFrameSlotView GetSlot(uint64_t index);
+
+private:
+    struct Header;
+
+    int memory_fd_ = -1;
+    int event_fd_ = -1;
+    uint8_t *mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    Header *header_ = nullptr;
+    uint32_t slot_count_ = 0;
+    size_t slot_size_ = 0;
+    size_t slot_stride_ = 0;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
+
+#endif // LMSHAO_REMOTE_DESK_SHM_FRAME_RING_H
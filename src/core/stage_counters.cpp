@@ -0,0 +1,217 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stage_counters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+using Reading = StageCounters::Scope::Reading;
+constexpr int COUNTER_COUNT = StageCounters::Scope::COUNTER_COUNT;
+
+#ifdef __linux__
+// Order matches StageCounterStats: cycles, instructions, LLC misses, branch misses
+constexpr uint64_t COUNTER_EVENTS[COUNTER_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+/**
+ * One counter group per thread, the cycles counter leads so that all four are scheduled together
+ * and read with a single read() call
+ */
+class CounterGroup {
+public:
+    ~CounterGroup() { Close(); }
+
+    bool Open()
+    {
+        if (opened_ || failed_) {
+            return opened_;
+        }
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = COUNTER_EVENTS[i];
+            attr.exclude_kernel = 1; // Allowed up to perf_event_paranoid 2, the default
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int group_fd = i == 0 ? -1 : fds_[0];
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+            if (fds_[i] < 0) {
+                error_ = errno;
+                Close();
+                failed_ = true;
+                return false;
+            }
+        }
+        opened_ = true;
+        return true;
+    }
+
+    bool Read(Reading &reading) const
+    {
+        struct {
+            uint64_t count;
+            uint64_t time_enabled;
+            uint64_t time_running;
+            uint64_t values[COUNTER_COUNT];
+        } buffer;
+        if (!opened_ || read(fds_[0], &buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) ||
+            buffer.count != COUNTER_COUNT) {
+            return false;
+        }
+        reading.time_enabled = buffer.time_enabled;
+        reading.time_running = buffer.time_running;
+        std::memcpy(reading.values, buffer.values, sizeof(reading.values));
+        return true;
+    }
+
+    int GetError() const { return error_; }
+
+private:
+    void Close()
+    {
+        for (int &fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        opened_ = false;
+    }
+
+    int fds_[COUNTER_COUNT] = {-1, -1, -1, -1};
+    bool opened_ = false;
+    bool failed_ = false; // Not retried, the reason does not go away while the process runs
+    int error_ = 0;
+};
+
+thread_local CounterGroup t_counter_group;
+#endif
+
+thread_local StageCounters::Scope *t_current_scope = nullptr;
+
+bool ReadCounters(Reading &reading)
+{
+#ifdef __linux__
+    return t_counter_group.Open() && t_counter_group.Read(reading);
+#else
+    (void)reading;
+    return false;
+#endif
+}
+
+} // namespace
+
+bool StageCounters::SetEnabled(bool enabled)
+{
+    if (!enabled) {
+        enabled_.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+#ifdef __linux__
+    // Probe on the calling thread, every other thread opens its own group on first use
+    if (!t_counter_group.Open()) {
+        LOG_WARN("Hardware performance counters unavailable: %s (check perf_event_paranoid)",
+                 std::strerror(t_counter_group.GetError()));
+        return false;
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+    LOG_INFO("Per-stage hardware performance counters enabled");
+    return true;
+#else
+    LOG_WARN("Hardware performance counters are only supported on Linux");
+    return false;
+#endif
+}
+
+StageCounterStats StageCounters::GetStats(uint64_t node_id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stages_.find(node_id);
+    return it != stages_.end() ? it->second : StageCounterStats{};
+}
+
+void StageCounters::ForgetStage(uint64_t node_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.erase(node_id);
+}
+
+void StageCounters::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.clear();
+}
+
+void StageCounters::Accumulate(uint64_t node_id, const uint64_t (&counts)[Scope::COUNTER_COUNT], bool multiplexed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &stats = stages_[node_id];
+    stats.invocations++;
+    stats.cycles += counts[0];
+    stats.instructions += counts[1];
+    stats.llc_misses += counts[2];
+    stats.branch_misses += counts[3];
+    stats.multiplexed += multiplexed ? 1 : 0;
+}
+
+void StageCounters::Scope::Begin(uint64_t node_id)
+{
+    if (!ReadCounters(start_)) {
+        return;
+    }
+    active_ = true;
+    node_id_ = node_id;
+    parent_ = t_current_scope;
+    t_current_scope = this;
+}
+
+void StageCounters::Scope::End()
+{
+    t_current_scope = parent_;
+
+    Reading end;
+    if (!ReadCounters(end)) {
+        return;
+    }
+
+    // Scale up for the share of the interval the counters were not scheduled
+    uint64_t enabled = end.time_enabled - start_.time_enabled;
+    uint64_t running = end.time_running - start_.time_running;
+    bool multiplexed = running > 0 && running < enabled;
+    double scale = multiplexed ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+
+    uint64_t inclusive[COUNTER_COUNT];
+    uint64_t exclusive[COUNTER_COUNT];
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        inclusive[i] = static_cast<uint64_t>(static_cast<double>(end.values[i] - start_.values[i]) * scale);
+        exclusive[i] = inclusive[i] > children_[i] ? inclusive[i] - children_[i] : 0;
+        if (parent_) {
+            parent_->children_[i] += inclusive[i];
+        }
+    }
+    StageCounters::GetInstance()->Accumulate(node_id_, exclusive, multiplexed);
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,132 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_STAGE_COUNTERS_H
+#define LMSHAO_REMOTE_DESK_STAGE_COUNTERS_H
+
+#include <coreutils/singleton.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace lmshao::remotedesk {
+
+using namespace lmshao::coreutils;
+
+/**
+ * @brief Hardware counters of one pipeline stage, summed over its invocations
+ * Counts are exclusive: work done by downstream stages called synchronously
+ * from the stage's OnFrame is attributed to those stages, not to this one.
+ */
+struct StageCounterStats {
+    uint64_t invocations = 0;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llc_misses = 0; // Last level cache misses
+    uint64_t branch_misses = 0;
+    uint64_t multiplexed = 0; // Invocations measured while the kernel time-shared the counters, scaled up
+
+    // Low instructions per cycle with many LLC misses per kilo-instruction points to a memory-bound stage
+    double InstructionsPerCycle() const { return cycles ? static_cast<double>(instructions) / cycles : 0.0; }
+    double LlcMissesPerKiloInstruction() const
+    {
+        return instructions ? static_cast<double>(llc_misses) * 1000.0 / instructions : 0.0;
+    }
+};
+
+/**
+ * @brief Optional per-stage hardware performance counters (Linux perf_event_open)
+ * While enabled, every frame delivered to a sink is measured with a group of
+ * user-space counters (cycles, instructions, LLC misses, branch misses) opened
+ * once per thread, and the deltas are added to the sink's entry. Disabled, the
+ * cost on the frame path is one relaxed atomic load. Hosts that forbid
+ * counters (perf_event_paranoid, containers without CAP_PERFMON) just leave
+ * the stats empty.
+ */
+class StageCounters : public Singleton<StageCounters> {
+    friend class Singleton<StageCounters>;
+
+public:
+    static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Turn counting on or off for all threads
+     * @return false if the counters cannot be opened on this host (counting stays off)
+     */
+    bool SetEnabled(bool enabled);
+
+    /**
+     * @brief Counters of one stage, keyed by INode::GetId()
+     */
+    StageCounterStats GetStats(uint64_t node_id) const;
+
+    /**
+     * @brief Drop the entry of a stage that is being destroyed, its id may be reused
+     */
+    void ForgetStage(uint64_t node_id);
+
+    void Reset();
+
+    /**
+     * @brief Measure one stage invocation on the calling thread
+     * Nested scopes on the same thread are subtracted from the enclosing one.
+     */
+    class Scope {
+    public:
+        static constexpr int COUNTER_COUNT = 4; // Cycles, instructions, LLC misses, branch misses
+
+        struct Reading {
+            uint64_t time_enabled = 0;
+            uint64_t time_running = 0; // Less than time_enabled while the counters were multiplexed
+            uint64_t values[COUNTER_COUNT] = {};
+        };
+
+        explicit Scope(uint64_t node_id)
+        {
+            if (IsEnabled()) {
+                Begin(node_id);
+            }
+        }
+        ~Scope()
+        {
+            if (active_) {
+                End();
+            }
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        void Begin(uint64_t node_id);
+        void End();
+
+        bool active_ = false;
+        uint64_t node_id_ = 0;
+        Reading start_;
+        uint64_t children_[COUNTER_COUNT] = {}; // Counted by nested scopes
+        Scope *parent_ = nullptr;
+    };
+
+protected:
+    StageCounters() = default;
+
+private:
+    void Accumulate(uint64_t node_id, const uint64_t (&counts)[Scope::COUNTER_COUNT], bool multiplexed);
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, StageCounterStats> stages_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_STAGE_COUNTERS_H
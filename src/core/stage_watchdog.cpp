@@ -0,0 +1,226 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stage_watchdog.h"
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+const char *GetStallStateName(StallState state)
+{
+    switch (state) {
+        case StallState::STALLED:
+            return "stalled";
+        case StallState::STUCK:
+            return "stuck";
+        case StallState::RECOVERED:
+            return "recovered";
+        default:
+            return "unknown";
+    }
+}
+
+StageHeartbeat::StageHeartbeat(const std::string &name, const std::string &owner, StageKind kind,
+                               std::chrono::milliseconds timeout)
+    : name_(name), owner_(owner), kind_(kind), timeout_(timeout), last_beat_ms_(NowMs())
+{
+}
+
+StageWatchdog::~StageWatchdog()
+{
+    Stop();
+}
+
+bool StageWatchdog::Start(const StageWatchdogConfig &config)
+{
+    if (config.check_interval.count() <= 0 || config.stall_timeout.count() <= 0) {
+        LOG_ERROR("Invalid watchdog config: check interval %lldms, stall timeout %lldms",
+                  static_cast<long long>(config.check_interval.count()),
+                  static_cast<long long>(config.stall_timeout.count()));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+    config_ = config;
+    running_ = true;
+    monitor_thread_ = std::thread(&StageWatchdog::MonitorThreadProc, this);
+    LOG_INFO("Stage watchdog started: stall timeout %lldms, stuck timeout %lldms",
+             static_cast<long long>(config_.stall_timeout.count()),
+             static_cast<long long>(config_.stuck_timeout.count()));
+    return true;
+}
+
+void StageWatchdog::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    monitor_cv_.notify_all();
+    if (monitor_thread_.joinable()) {
+        monitor_thread_.join();
+    }
+    LOG_INFO("Stage watchdog stopped");
+}
+
+std::shared_ptr<StageHeartbeat> StageWatchdog::RegisterStage(const std::string &name, const std::string &owner,
+                                                             StageKind kind, std::chrono::milliseconds timeout)
+{
+    auto heartbeat = std::make_shared<StageHeartbeat>(name, owner, kind, timeout);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.push_back(heartbeat);
+    return heartbeat;
+}
+
+uint64_t StageWatchdog::AddStallListener(StallListener listener)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t listener_id = next_listener_id_++;
+    listeners_[listener_id] = std::move(listener);
+    return listener_id;
+}
+
+void StageWatchdog::RemoveStallListener(uint64_t listener_id)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listeners_.erase(listener_id);
+    }
+    // Wait for a dispatch that copied the listener before it was erased
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+}
+
+StageWatchdog::WatchdogStats StageWatchdog::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void StageWatchdog::MonitorThreadProc()
+{
+    std::vector<StallEvent> events;
+    std::vector<StallListener> listeners;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        monitor_cv_.wait_for(lock, config_.check_interval, [this] { return !running_; });
+        if (!running_) {
+            break;
+        }
+
+        events.clear();
+        CheckStages(StageHeartbeat::NowMs(), events);
+        if (events.empty()) {
+            continue;
+        }
+
+        listeners.clear();
+        for (const auto &entry : listeners_) {
+            listeners.push_back(entry.second);
+        }
+
+        // Listeners may register and release stages. The dispatch lock is taken before mutex_ is released,
+        // so that RemoveStallListener() cannot return between the copy and the calls.
+        std::unique_lock<std::mutex> dispatch_lock(dispatch_mutex_);
+        lock.unlock();
+        for (const auto &event : events) {
+            if (event.state == StallState::RECOVERED) {
+                LOG_INFO("Stage %s of %s recovered after %lldms", event.stage.c_str(), event.owner.c_str(),
+                         static_cast<long long>(event.duration.count()));
+            } else {
+                LOG_WARN("Stage %s of %s %s: no progress for %lldms (%u stalls recently)", event.stage.c_str(),
+                         event.owner.c_str(), GetStallStateName(event.state),
+                         static_cast<long long>(event.duration.count()), event.recent_stalls);
+            }
+            for (const auto &listener : listeners) {
+                listener(event);
+            }
+        }
+        dispatch_lock.unlock();
+        lock.lock();
+    }
+}
+
+void StageWatchdog::CheckStages(int64_t now_ms, std::vector<StallEvent> &events)
+{
+    const int64_t stuck_ms = config_.stuck_timeout.count();
+    const int64_t window_ms = config_.stall_window.count();
+    size_t stalled_count = 0;
+
+    auto it = stages_.begin();
+    while (it != stages_.end()) {
+        auto heartbeat = it->lock();
+        if (!heartbeat) {
+            it = stages_.erase(it);
+            continue;
+        }
+        ++it;
+
+        StageHeartbeat &stage = *heartbeat;
+        int64_t timeout_ms = stage.timeout_.count() > 0 ? stage.timeout_.count() : config_.stall_timeout.count();
+
+        // When the stage last showed progress, -1 when it has nothing to do
+        int64_t progress_ms = -1;
+        if (stage.kind_ == StageKind::LOOP) {
+            progress_ms = stage.last_beat_ms_.load(std::memory_order_relaxed);
+        } else {
+            int64_t busy_since = stage.busy_since_ms_.load(std::memory_order_relaxed);
+            progress_ms = busy_since != 0 ? busy_since : -1;
+        }
+        bool stalled = progress_ms >= 0 && now_ms - progress_ms > timeout_ms;
+
+        while (!stage.stall_history_ms_.empty() && now_ms - stage.stall_history_ms_.front() > window_ms) {
+            stage.stall_history_ms_.pop_front();
+        }
+
+        StallEvent event;
+        event.stage = stage.name_;
+        event.owner = stage.owner_;
+        if (stalled) {
+            stalled_count++;
+            if (stage.stall_start_ms_ == 0) {
+                stage.stall_start_ms_ = progress_ms;
+                stage.stall_history_ms_.push_back(now_ms);
+                stats_.stalls++;
+                event.state = StallState::STALLED;
+            } else if (!stage.stuck_reported_ && stuck_ms > 0 && now_ms - stage.stall_start_ms_ >= stuck_ms) {
+                stage.stuck_reported_ = true;
+                stats_.stuck++;
+                event.state = StallState::STUCK;
+            } else {
+                continue;
+            }
+        } else if (stage.stall_start_ms_ != 0) {
+            stats_.recoveries++;
+            event.state = StallState::RECOVERED;
+        } else {
+            continue;
+        }
+
+        event.duration = std::chrono::milliseconds(now_ms - stage.stall_start_ms_);
+        event.recent_stalls = static_cast<uint32_t>(stage.stall_history_ms_.size());
+        events.push_back(std::move(event));
+
+        if (!stalled) {
+            stage.stall_start_ms_ = 0;
+            stage.stuck_reported_ = false;
+        }
+    }
+
+    stats_.stages = stages_.size();
+    stats_.stalled = stalled_count;
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,211 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_STAGE_WATCHDOG_H
+#define LMSHAO_REMOTE_DESK_STAGE_WATCHDOG_H
+
+#include <coreutils/singleton.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+using namespace lmshao::coreutils;
+
+/**
+ * @brief How a stage shows progress
+ */
+enum class StageKind {
+    LOOP = 0, // Iterates continuously (capture loop): stalled when Beat() is not called for the timeout
+    WORK = 1, // Runs work items (OnFrame tasks): stalled when one item runs longer than the timeout
+};
+
+/**
+ * @brief Stage watchdog configuration
+ */
+struct StageWatchdogConfig {
+    std::chrono::milliseconds check_interval{250};
+    std::chrono::milliseconds stall_timeout{2000};  // Default timeout of stages registered without one
+    std::chrono::milliseconds stuck_timeout{10000}; // Stalled this long: reported STUCK, the owner should restart it
+    std::chrono::milliseconds stall_window{60000};  // StallEvent::recent_stalls counts the episodes in this window
+};
+
+/**
+ * @brief Progress beacon of one stage, updated by the stage's own thread
+ * Updates are relaxed atomic stores of a millisecond clock. The stage stops
+ * being watched when its last reference is released.
+ */
+class StageHeartbeat {
+public:
+    StageHeartbeat(const std::string &name, const std::string &owner, StageKind kind,
+                   std::chrono::milliseconds timeout);
+
+    /**
+     * @brief LOOP stages: one iteration completed
+     */
+    void Beat() { last_beat_ms_.store(NowMs(), std::memory_order_relaxed); }
+
+    /**
+     * @brief WORK stages: an item started / completed
+     */
+    void BeginWork() { busy_since_ms_.store(NowMs(), std::memory_order_relaxed); }
+    void EndWork() { busy_since_ms_.store(0, std::memory_order_relaxed); }
+
+    class WorkScope {
+    public:
+        explicit WorkScope(StageHeartbeat *heartbeat) : heartbeat_(heartbeat)
+        {
+            if (heartbeat_) {
+                heartbeat_->BeginWork();
+            }
+        }
+        ~WorkScope()
+        {
+            if (heartbeat_) {
+                heartbeat_->EndWork();
+            }
+        }
+        WorkScope(const WorkScope &) = delete;
+        WorkScope &operator=(const WorkScope &) = delete;
+
+    private:
+        StageHeartbeat *heartbeat_;
+    };
+
+    const std::string &GetName() const { return name_; }
+    const std::string &GetOwner() const { return owner_; }
+
+    static int64_t NowMs()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    }
+
+private:
+    friend class StageWatchdog;
+
+    const std::string name_;
+    const std::string owner_; // Session id or display name the stage works for
+    const StageKind kind_;
+    const std::chrono::milliseconds timeout_;
+
+    std::atomic<int64_t> last_beat_ms_;
+    std::atomic<int64_t> busy_since_ms_{0};
+
+    // Monitor thread only
+    int64_t stall_start_ms_ = 0; // 0 = not stalled
+    bool stuck_reported_ = false;
+    std::deque<int64_t> stall_history_ms_;
+};
+
+/**
+ * @brief State change reported for a stage
+ */
+enum class StallState {
+    STALLED = 0,   // No progress for the stage's timeout
+    STUCK = 1,     // Still stalled after stuck_timeout, reported once per episode
+    RECOVERED = 2, // Progress resumed
+};
+
+const char *GetStallStateName(StallState state);
+
+struct StallEvent {
+    std::string stage;
+    std::string owner;
+    StallState state = StallState::STALLED;
+    std::chrono::milliseconds duration{0}; // Time without progress so far (RECOVERED: whole episode)
+    uint32_t recent_stalls = 0;            // Episodes of this stage within stall_window, this one included
+};
+
+/**
+ * @brief Detects pipeline stages and threads that stopped making progress
+ * Capture loops and pooled processing stages register a StageHeartbeat and
+ * update it as they work; a monitor thread compares each heartbeat with its
+ * timeout and reports STALLED, STUCK and RECOVERED transitions to listeners.
+ * A hung XGetImage or encoder thus produces an event instead of a silently
+ * frozen stream. What to do about it (notify, lower the frame rate, restart
+ * the stage) is decided by the listener, typically the owning service.
+ */
+class StageWatchdog : public Singleton<StageWatchdog> {
+    friend class Singleton<StageWatchdog>;
+
+public:
+    using StallListener = std::function<void(const StallEvent &)>;
+
+    ~StageWatchdog();
+
+    bool Start(const StageWatchdogConfig &config = {});
+    void Stop();
+
+    /**
+     * @brief Watch a stage until the returned heartbeat is released
+     * @param timeout Time without progress that counts as a stall (0 = config stall_timeout)
+     */
+    std::shared_ptr<StageHeartbeat> RegisterStage(const std::string &name, const std::string &owner, StageKind kind,
+                                                  std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /**
+     * @brief Register a listener, called on the monitor thread; it must not block
+     * @return Listener id for RemoveStallListener()
+     */
+    uint64_t AddStallListener(StallListener listener);
+
+    /**
+     * @brief Returns once no call of the listener is in progress; must not be called from a listener
+     */
+    void RemoveStallListener(uint64_t listener_id);
+
+    struct WatchdogStats {
+        size_t stages = 0;
+        size_t stalled = 0; // Currently stalled
+        uint64_t stalls = 0;
+        uint64_t stuck = 0;
+        uint64_t recoveries = 0;
+    };
+    WatchdogStats GetStats() const;
+
+protected:
+    StageWatchdog() = default;
+
+private:
+    void MonitorThreadProc();
+
+    /**
+     * @brief Compare every heartbeat with its timeout and collect the state changes
+     */
+    void CheckStages(int64_t now_ms, std::vector<StallEvent> &events);
+
+private:
+    StageWatchdogConfig config_;
+
+    mutable std::mutex mutex_;
+    std::mutex dispatch_mutex_; // Held while listeners run, outside mutex_
+    std::vector<std::weak_ptr<StageHeartbeat>> stages_;
+    std::map<uint64_t, StallListener> listeners_;
+    uint64_t next_listener_id_ = 1;
+    WatchdogStats stats_;
+
+    std::thread monitor_thread_;
+    std::condition_variable monitor_cv_;
+    bool running_ = false;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_STAGE_WATCHDOG_H
@@ -0,0 +1,190 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_STATIC_PIPELINE_H
+#define LMSHAO_REMOTE_DESK_STATIC_PIPELINE_H
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "media_processor.h"
+#include "media_sink.h"
+
+namespace lmshao::remotedesk {
+
+namespace static_pipeline_detail {
+
+// Stage that transforms a frame: std::shared_ptr<Frame> Process(const std::shared_ptr<Frame> &), nullptr drops it
+template <typename T, typename = void>
+struct HasProcess : std::false_type {};
+template <typename T>
+struct HasProcess<T, std::void_t<decltype(std::declval<T &>().Process(std::declval<const std::shared_ptr<Frame> &>()))>>
+    : std::true_type {};
+
+// Stage that only decides whether a frame passes: bool Accept(const Frame &)
+template <typename T, typename = void>
+struct HasAccept : std::false_type {};
+template <typename T>
+struct HasAccept<T, std::void_t<decltype(std::declval<T &>().Accept(std::declval<const Frame &>()))>>
+    : std::true_type {};
+
+} // namespace static_pipeline_detail
+
+/**
+ * @brief Processing chain whose stages are linked at compile time
+ * Each stage is called through a qualified, non-virtual call on its concrete
+ * type: transform stages through Process(), filter stages through Accept(),
+ * and the last stage may be any ISink, called through Stage::OnFrame. No
+ * sink list is walked between stages and the calls can be inlined across
+ * stages. The chain itself is a MediaProcessor, so it can be added to a
+ * dynamic Pipeline like any other processor. Frames that leave the last
+ * transform or filter stage are delivered to the sinks of the chain.
+ *
+ * Example: StaticPipeline<VideoScaler, PixelFormatConverter, VideoEncoder>
+ */
+template <typename... Stages>
+class StaticPipeline : public MediaProcessor {
+    static_assert(sizeof...(Stages) > 0, "StaticPipeline needs at least one stage");
+
+public:
+    explicit StaticPipeline(std::shared_ptr<Stages>... stages) : stages_(std::move(stages)...) {}
+    ~StaticPipeline() override = default;
+
+    // MediaProcessor interface implementation
+    bool Initialize() override
+    {
+        return std::apply([](auto &...stage) { return (InitializeStage(*stage) && ...); }, stages_);
+    }
+
+    void Cleanup() override
+    {
+        std::apply([](auto &...stage) { (CleanupStage(*stage), ...); }, stages_);
+    }
+
+    bool IsReady() const override
+    {
+        return std::apply([](const auto &...stage) { return (IsStageReady(*stage) && ...); }, stages_);
+    }
+
+    bool Start() override
+    {
+        return std::apply([](auto &...stage) { return (StartStage(*stage) && ...); }, stages_);
+    }
+
+    void Stop() override
+    {
+        std::apply([](auto &...stage) { (StopStage(*stage), ...); }, stages_);
+    }
+
+    void OnFrame(const std::shared_ptr<Frame> &frame) override
+    {
+        if (frame) {
+            Run<0>(frame);
+        }
+    }
+
+    /**
+     * @brief Access a stage, e.g. to change the scaler target at runtime
+     */
+    template <size_t I>
+    auto &GetStage() const
+    {
+        return *std::get<I>(stages_);
+    }
+
+    static constexpr size_t GetStageCount() { return sizeof...(Stages); }
+
+private:
+    using StageTuple = std::tuple<Stages...>;
+
+    template <size_t I>
+    void Run(const std::shared_ptr<Frame> &frame)
+    {
+        if constexpr (I == sizeof...(Stages)) {
+            DeliverFrame(frame);
+        } else {
+            using Stage = std::tuple_element_t<I, StageTuple>;
+            Stage &stage = *std::get<I>(stages_);
+
+            if constexpr (static_pipeline_detail::HasProcess<Stage>::value) {
+                auto output = stage.Stage::Process(frame);
+                if (output) {
+                    Run<I + 1>(output);
+                }
+            } else if constexpr (static_pipeline_detail::HasAccept<Stage>::value) {
+                if (stage.Stage::Accept(*frame)) {
+                    Run<I + 1>(frame);
+                }
+            } else {
+                static_assert(I + 1 == sizeof...(Stages),
+                              "Only the last stage may be a plain sink without Process() or Accept()");
+                stage.Stage::OnFrame(frame);
+            }
+        }
+    }
+
+    // Stages that are not MediaProcessor/MediaSink (plain Process() types) have no lifecycle
+    template <typename Stage>
+    static constexpr bool HAS_LIFECYCLE =
+        std::is_base_of_v<MediaProcessor, Stage> || std::is_base_of_v<MediaSink, Stage>;
+
+    template <typename Stage>
+    static bool InitializeStage(Stage &stage)
+    {
+        if constexpr (HAS_LIFECYCLE<Stage>) {
+            return stage.Initialize();
+        } else {
+            return true;
+        }
+    }
+
+    template <typename Stage>
+    static void CleanupStage(Stage &stage)
+    {
+        if constexpr (std::is_base_of_v<MediaProcessor, Stage>) {
+            stage.Cleanup();
+        }
+    }
+
+    template <typename Stage>
+    static bool StartStage(Stage &stage)
+    {
+        if constexpr (HAS_LIFECYCLE<Stage>) {
+            return stage.Start();
+        } else {
+            return true;
+        }
+    }
+
+    template <typename Stage>
+    static void StopStage(Stage &stage)
+    {
+        if constexpr (HAS_LIFECYCLE<Stage>) {
+            stage.Stop();
+        }
+    }
+
+    template <typename Stage>
+    static bool IsStageReady(const Stage &stage)
+    {
+        if constexpr (std::is_base_of_v<MediaProcessor, Stage>) {
+            return stage.IsReady();
+        } else {
+            return true;
+        }
+    }
+
+private:
+    std::tuple<std::shared_ptr<Stages>...> stages_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_STATIC_PIPELINE_H
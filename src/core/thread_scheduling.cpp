@@ -0,0 +1,156 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "thread_scheduling.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+std::string FormatCpuList(const std::vector<uint32_t> &cpus)
+{
+    std::string list;
+    for (uint32_t cpu : cpus) {
+        list += list.empty() ? "" : ",";
+        list += std::to_string(cpu);
+    }
+    return list;
+}
+
+} // namespace
+
+const char *GetSchedulingPolicyName(SchedulingPolicy policy)
+{
+    switch (policy) {
+        case SchedulingPolicy::FIFO:
+            return "SCHED_FIFO";
+        case SchedulingPolicy::ROUND_ROBIN:
+            return "SCHED_RR";
+        default:
+            return "SCHED_OTHER";
+    }
+}
+
+bool ApplyThreadScheduling(const ThreadSchedulingConfig &config, const char *thread_name)
+{
+    if (config.IsDefault()) {
+        return true;
+    }
+
+#ifdef __linux__
+    bool applied = true;
+
+    if (!config.cpus.empty()) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (uint32_t cpu : config.cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpu_set);
+            }
+        }
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (ret != 0) {
+            LOG_ERROR("Failed to pin %s thread to cpus %s: %s", thread_name, FormatCpuList(config.cpus).c_str(),
+                      strerror(ret));
+            applied = false;
+        }
+    }
+
+    bool realtime = false;
+    sched_param param{};
+    if (config.policy != SchedulingPolicy::DEFAULT) {
+        int policy = config.policy == SchedulingPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+        param.sched_priority =
+            std::clamp(config.priority, sched_get_priority_min(policy), sched_get_priority_max(policy));
+        int ret = pthread_setschedparam(pthread_self(), policy, &param);
+        if (ret == 0) {
+            realtime = true;
+        } else {
+            LOG_WARN("%s for %s thread denied (%s), falling back to nice %d",
+                     GetSchedulingPolicyName(config.policy), thread_name, strerror(ret), config.nice);
+            applied = false;
+        }
+    }
+
+    // On Linux the nice level is per thread, addressed by its tid
+    if (!realtime && config.nice != 0) {
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), config.nice) != 0) {
+            LOG_WARN("Failed to set nice %d for %s thread: %s", config.nice, thread_name, strerror(errno));
+            applied = false;
+        }
+    }
+
+    LOG_INFO("%s thread: %s priority %d, nice %d, cpus %s", thread_name,
+             GetSchedulingPolicyName(realtime ? config.policy : SchedulingPolicy::DEFAULT),
+             realtime ? param.sched_priority : 0, realtime ? 0 : config.nice,
+             config.cpus.empty() ? "any" : FormatCpuList(config.cpus).c_str());
+    return applied;
+#else
+    (void)thread_name;
+    LOG_WARN("Thread scheduling of the %s thread is only supported on Linux", thread_name);
+    return false;
+#endif
+}
+
+bool LockMemoryRange(const void *address, size_t size, const char *what)
+{
+#ifdef __linux__
+    if (mlock(address, size) != 0) {
+        LOG_ERROR("Failed to lock %zu bytes of %s: %s (check ulimit -l or CAP_IPC_LOCK)", size, what,
+                  strerror(errno));
+        return false;
+    }
+    LOG_DEBUG("Locked %zu bytes of %s", size, what);
+    return true;
+#else
+    (void)address;
+    (void)size;
+    (void)what;
+    LOG_WARN("Locking %zu bytes of %s is only supported on Linux", size, what);
+    return false;
+#endif
+}
+
+bool LockProcessMemory()
+{
+#ifdef __linux__
+    rlimit limit{};
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY && geteuid() != 0) {
+        LOG_WARN("Not locking process memory: RLIMIT_MEMLOCK is %llu bytes, allocations past it would fail",
+                 static_cast<unsigned long long>(limit.rlim_cur));
+        return false;
+    }
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG_ERROR("Failed to lock process memory: %s", strerror(errno));
+        return false;
+    }
+    LOG_INFO("Process memory locked");
+    return true;
+#else
+    LOG_WARN("Locking process memory is only supported on Linux");
+    return false;
+#endif
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,74 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_THREAD_SCHEDULING_H
+#define LMSHAO_REMOTE_DESK_THREAD_SCHEDULING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Kernel scheduling policy of a latency-critical thread
+ */
+enum class SchedulingPolicy {
+    DEFAULT = 0,     // SCHED_OTHER, only the nice level applies
+    FIFO = 1,        // SCHED_FIFO: runs until it blocks or a higher priority thread is runnable
+    ROUND_ROBIN = 2, // SCHED_RR: like FIFO, time sliced among threads of equal priority
+};
+
+/**
+ * @brief Scheduling of a pipeline thread; the defaults leave the thread untouched
+ * Real-time policies need CAP_SYS_NICE or an RLIMIT_RTPRIO of at least
+ * priority, negative nice levels CAP_SYS_NICE or RLIMIT_NICE. When the
+ * real-time policy is denied the thread gets the nice level instead. A
+ * real-time thread that never blocks starves other threads on its cores,
+ * only the kernel's RT throttling (sched_rt_runtime_us) still lets them run.
+ */
+struct ThreadSchedulingConfig {
+    SchedulingPolicy policy = SchedulingPolicy::DEFAULT;
+    int priority = 10;          // FIFO/ROUND_ROBIN priority, clamped to 1..99
+    int nice = 0;               // DEFAULT policy, or fallback when real-time scheduling is denied (0 = unchanged)
+    std::vector<uint32_t> cpus; // Cores the thread may run on (empty = any)
+
+    bool IsDefault() const { return policy == SchedulingPolicy::DEFAULT && nice == 0 && cpus.empty(); }
+};
+
+/**
+ * @brief Kernel name of a scheduling policy, e.g. "SCHED_FIFO"
+ */
+const char *GetSchedulingPolicyName(SchedulingPolicy policy);
+
+/**
+ * @brief Apply a scheduling config to the calling thread
+ * @param thread_name Used in log messages
+ * @return false if any part of the config could not be applied (the rest still is)
+ */
+bool ApplyThreadScheduling(const ThreadSchedulingConfig &config, const char *thread_name);
+
+/**
+ * @brief Fault in and lock a memory range, so that touching it never page faults
+ * Locked memory counts against RLIMIT_MEMLOCK unless the process has
+ * CAP_IPC_LOCK. Unmapping the range unlocks it.
+ * @param what Used in log messages
+ */
+bool LockMemoryRange(const void *address, size_t size, const char *what);
+
+/**
+ * @brief Lock all current and future memory of the process (mlockall)
+ * Frame buffers are allocated per frame, so locking them one by one is not
+ * possible. Refused unless RLIMIT_MEMLOCK is unlimited or the process runs as
+ * root, since with a finite limit every allocation past it would fail.
+ */
+bool LockProcessMemory();
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_THREAD_SCHEDULING_H
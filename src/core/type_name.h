@@ -0,0 +1,48 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_TYPE_NAME_H
+#define LMSHAO_REMOTE_DESK_TYPE_NAME_H
+
+#include <cstdlib>
+#include <string>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#endif
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Readable class name from typeid(...).name(), without namespaces, for logs and traces
+ */
+inline std::string GetTypeName(const char *mangled_name)
+{
+    std::string name = mangled_name;
+#if defined(__GNUC__) || defined(__clang__)
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(mangled_name, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+    // MSVC names start with "class "
+    if (name.compare(0, 6, "class ") == 0) {
+        name = name.substr(6);
+    }
+    auto scope = name.rfind("::");
+    if (scope != std::string::npos && name.find('<') == std::string::npos) {
+        name = name.substr(scope + 2);
+    }
+    return name;
+}
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_TYPE_NAME_H
@@ -0,0 +1,250 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "encoder_context_pool.h"
+
+#include <algorithm>
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+EncoderContextKey EncoderContextKey::FromConfig(const VideoEncoderConfig &config)
+{
+    EncoderContextKey key;
+    key.codec = config.output_format;
+    key.width = config.width;
+    key.height = config.height;
+
+    // gop:20 | high_bit_depth:1 | lossless:1 | full_chroma:1 | intra_refresh:1 | temporal_layers:3 |
+    // fps:16 | threads:8 | preset:4 | screen_content:1
+    uint64_t gop = std::min<uint64_t>(config.keyframe_interval, 0xFFFFFull);
+    uint64_t high_bit_depth = config.bit_depth > 8 ? 1 : 0;
+    uint64_t lossless = config.lossless ? 1 : 0;
+    uint64_t full_chroma = config.full_chroma ? 1 : 0;
+    uint64_t intra_refresh = config.intra_refresh ? 1 : 0;
+    uint64_t layers = std::min<uint64_t>(config.temporal_layers, 0x07ull);
+    uint64_t fps = std::min<uint64_t>(config.fps, 0xFFFFull);
+    uint64_t threads = std::min<uint64_t>(config.thread_count, 0xFFull);
+    uint64_t preset = static_cast<uint64_t>(config.speed_preset) & 0x0F;
+    key.profile = (gop << 36) | (high_bit_depth << 35) | (lossless << 34) | (full_chroma << 33) |
+                  (intra_refresh << 32) | (layers << 29) | (fps << 13) | (threads << 5) | (preset << 1) |
+                  (config.screen_content ? 1 : 0);
+    return key;
+}
+
+void EncoderContextPool::ContextDeleter::operator()(AVCodecContext *ctx) const
+{
+    avcodec_free_context(&ctx);
+}
+
+EncoderContextPool::EncoderContextPool() = default;
+
+EncoderContextPool::~EncoderContextPool()
+{
+    Clear();
+}
+
+EncoderContextPool::ContextPtr EncoderContextPool::Acquire(const VideoEncoderConfig &config, bool *reused)
+{
+    auto key = EncoderContextKey::FromConfig(config);
+    if (reused) {
+        *reused = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(key);
+        if (it != idle_.end() && !it->second.empty()) {
+            // Most recently returned first: its buffers are most likely still cache/TLB warm
+            ContextPtr ctx = std::move(it->second.back().ctx);
+            it->second.pop_back();
+            if (it->second.empty()) {
+                idle_.erase(it);
+            }
+            idle_count_--;
+            stats_.hits++;
+            ctx->bit_rate = config.bitrate;
+            if (reused) {
+                *reused = true;
+            }
+            LOG_DEBUG("Encoder context pool hit for %ux%u codec=%d", config.width, config.height,
+                      static_cast<int>(config.output_format));
+            return ctx;
+        }
+        stats_.misses++;
+    }
+
+    return OpenContext(config);
+}
+
+void EncoderContextPool::Release(const VideoEncoderConfig &config, ContextPtr ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    if (!ctx->codec || !(ctx->codec->capabilities & AV_CODEC_CAP_ENCODER_FLUSH)) {
+        LOG_DEBUG("Encoder %s cannot be flushed, freeing context instead of pooling",
+                  ctx->codec ? ctx->codec->name : "unknown");
+        return;
+    }
+    if (config.intra_refresh) {
+        LOG_DEBUG("Intra refresh encoder context cannot start a new session with an IDR, freeing it");
+        return;
+    }
+
+    // Drop any queued input and reference state so the next user starts with a clean GOP
+    avcodec_flush_buffers(ctx.get());
+
+    auto key = EncoderContextKey::FromConfig(config);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &queue = idle_[key];
+    if (queue.size() >= max_idle_per_key_) {
+        stats_.evictions++;
+        return;
+    }
+    queue.push_back({std::move(ctx), std::chrono::steady_clock::now()});
+    idle_count_++;
+    EvictLocked();
+}
+
+size_t EncoderContextPool::Prewarm(const VideoEncoderConfig &config, size_t count)
+{
+    auto key = EncoderContextKey::FromConfig(config);
+
+    size_t missing = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(key);
+        size_t existing = it != idle_.end() ? it->second.size() : 0;
+        count = std::min(count, max_idle_per_key_);
+        missing = count > existing ? count - existing : 0;
+    }
+
+    // Open outside the lock, this is the expensive part
+    for (size_t i = 0; i < missing; ++i) {
+        auto ctx = OpenContext(config);
+        if (!ctx) {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_[key].push_back({std::move(ctx), std::chrono::steady_clock::now()});
+        idle_count_++;
+        EvictLocked();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(key);
+    return it != idle_.end() ? it->second.size() : 0;
+}
+
+void EncoderContextPool::SetLimits(size_t max_idle_per_key, size_t max_idle_total)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_idle_per_key_ = max_idle_per_key;
+    max_idle_total_ = max_idle_total;
+
+    for (auto it = idle_.begin(); it != idle_.end();) {
+        while (it->second.size() > max_idle_per_key_) {
+            it->second.pop_front();
+            idle_count_--;
+            stats_.evictions++;
+        }
+        it = it->second.empty() ? idle_.erase(it) : std::next(it);
+    }
+    EvictLocked();
+}
+
+void EncoderContextPool::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+    idle_count_ = 0;
+}
+
+EncoderContextPool::PoolStats EncoderContextPool::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    PoolStats stats = stats_;
+    stats.idle_contexts = idle_count_;
+    return stats;
+}
+
+EncoderContextPool::ContextPtr EncoderContextPool::OpenContext(const VideoEncoderConfig &config)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    auto backend = VideoCodecBackend::Create(config.output_format);
+    if (!backend) {
+        return nullptr;
+    }
+
+    const AVCodec *codec = backend->FindEncoder();
+    if (!codec) {
+        LOG_ERROR("No %s encoder available in this FFmpeg build", backend->GetName());
+        return nullptr;
+    }
+
+    ContextPtr ctx(avcodec_alloc_context3(codec));
+    if (!ctx) {
+        LOG_ERROR("Failed to allocate %s codec context", backend->GetName());
+        return nullptr;
+    }
+
+    AVDictionary *options = nullptr;
+    if (!backend->Configure(ctx.get(), codec, config, &options)) {
+        av_dict_free(&options);
+        return nullptr;
+    }
+
+    int ret = avcodec_open2(ctx.get(), codec, &options);
+    av_dict_free(&options);
+    if (ret < 0) {
+        LOG_ERROR("Failed to open %s encoder (%s) for %ux%u: %d", backend->GetName(), codec->name, config.width,
+                  config.height, ret);
+        return nullptr;
+    }
+
+    auto open_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG_INFO("Opened %s encoder (%s) %ux%u in %lldms", backend->GetName(), codec->name, config.width, config.height,
+             static_cast<long long>(open_time.count()));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.contexts_opened++;
+    auto new_avg = stats_.avg_open_time.count() +
+                   (open_time.count() - stats_.avg_open_time.count()) / static_cast<long long>(stats_.contexts_opened);
+    stats_.avg_open_time = std::chrono::milliseconds(static_cast<long long>(new_avg));
+    return ctx;
+}
+
+void EncoderContextPool::EvictLocked()
+{
+    while (idle_count_ > max_idle_total_) {
+        // Evict the context that has been idle the longest across all keys
+        auto oldest = idle_.end();
+        for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+            if (!it->second.empty() &&
+                (oldest == idle_.end() || it->second.front().returned_at < oldest->second.front().returned_at)) {
+                oldest = it;
+            }
+        }
+        if (oldest == idle_.end()) {
+            break;
+        }
+        oldest->second.pop_front();
+        if (oldest->second.empty()) {
+            idle_.erase(oldest);
+        }
+        idle_count_--;
+        stats_.evictions++;
+    }
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,138 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_ENCODER_CONTEXT_POOL_H
+#define LMSHAO_REMOTE_DESK_ENCODER_CONTEXT_POOL_H
+
+#include <coreutils/singleton.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "video_encoder.h"
+
+namespace lmshao::remotedesk {
+
+using namespace lmshao::coreutils;
+
+/**
+ * @brief Identifies encoder contexts that can be reused for each other
+ * Bitrate is deliberately not part of the key: it can be changed on an open context.
+ */
+struct EncoderContextKey {
+    FrameFormat codec = FrameFormat::H264;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t profile = 0; // Packed GOP, fps, threads, speed preset and tuning flags
+
+    static EncoderContextKey FromConfig(const VideoEncoderConfig &config);
+
+    bool operator<(const EncoderContextKey &other) const
+    {
+        return std::tie(codec, width, height, profile) <
+               std::tie(other.codec, other.width, other.height, other.profile);
+    }
+};
+
+/**
+ * @brief Pool of opened libavcodec encoder contexts
+ * Opening an encoder costs tens of milliseconds and allocates lookahead and
+ * reference buffers. VideoEncoder checks contexts out of this pool on
+ * session start and resolution changes, and returns them instead of freeing
+ * them. Returned contexts are flushed; encoders that cannot be flushed
+ * (no AV_CODEC_CAP_ENCODER_FLUSH, i.e. everything but libx264 in current
+ * FFmpeg) are freed instead of pooled, and so are intra refresh contexts,
+ * whose forced keyframes are refresh waves rather than IDRs.
+ */
+class EncoderContextPool : public Singleton<EncoderContextPool> {
+    friend class Singleton<EncoderContextPool>;
+
+public:
+    struct ContextDeleter {
+        void operator()(AVCodecContext *ctx) const;
+    };
+    using ContextPtr = std::unique_ptr<AVCodecContext, ContextDeleter>;
+
+    ~EncoderContextPool();
+
+    /**
+     * @brief Check out a warm context for the configuration, opening a new one on a miss
+     * Flushing does not reset the GOP: a reused context would predict its next frame
+     * from the previous user's pictures. The caller must send its first frame with
+     * pict_type = AV_PICTURE_TYPE_I, which the pooled encoders turn into an IDR.
+     * @param reused Set to whether the context came from the pool
+     * @return nullptr if the encoder cannot be opened
+     */
+    ContextPtr Acquire(const VideoEncoderConfig &config, bool *reused = nullptr);
+
+    /**
+     * @brief Return a context after the caller has drained its packets
+     */
+    void Release(const VideoEncoderConfig &config, ContextPtr ctx);
+
+    /**
+     * @brief Open contexts ahead of time so that the first session starts immediately
+     * @return Number of contexts idle for this configuration afterwards
+     */
+    size_t Prewarm(const VideoEncoderConfig &config, size_t count);
+
+    /**
+     * @brief Limit idle contexts kept per key and in total
+     */
+    void SetLimits(size_t max_idle_per_key, size_t max_idle_total);
+
+    /**
+     * @brief Free all idle contexts
+     */
+    void Clear();
+
+    struct PoolStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t contexts_opened = 0;
+        size_t idle_contexts = 0;
+        std::chrono::milliseconds avg_open_time{0};
+    };
+    PoolStats GetStats() const;
+
+protected:
+    EncoderContextPool();
+
+private:
+    /**
+     * @brief Allocate, configure and open a new encoder context
+     */
+    ContextPtr OpenContext(const VideoEncoderConfig &config);
+
+    /**
+     * @brief Drop the oldest idle contexts until the total limit holds (mutex_ held)
+     */
+    void EvictLocked();
+
+private:
+    struct IdleContext {
+        ContextPtr ctx;
+        std::chrono::steady_clock::time_point returned_at;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<EncoderContextKey, std::deque<IdleContext>> idle_;
+    size_t idle_count_ = 0;
+    size_t max_idle_per_key_ = 2;
+    size_t max_idle_total_ = 8;
+    PoolStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_ENCODER_CONTEXT_POOL_H
@@ -0,0 +1,341 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "kernel_autotuner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../log/remote_desk_log.h"
+#include "pixel_format_converter.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+constexpr int PROFILE_VERSION = 1;
+constexpr uint32_t MAX_TUNED_THREADS = 8;
+
+// Variants closer than this to the fastest one count as equally fast, the narrower or
+// lower thread count one is kept since it leaves more clock and cores to the rest
+constexpr double TIE_TOLERANCE = 0.03;
+
+std::mutex &ActiveProfileMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+KernelProfile &ActiveProfile()
+{
+    static KernelProfile profile;
+    return profile;
+}
+
+std::string ReadCpuModel()
+{
+#ifdef __linux__
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            auto colon = line.find(':');
+            if (colon != std::string::npos) {
+                return line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+        }
+    }
+#endif
+    return "unknown";
+}
+
+bool ParseSimdLevel(const std::string &name, SimdLevel &level)
+{
+    for (int i = static_cast<int>(SimdLevel::SCALAR); i <= static_cast<int>(SimdLevel::AVX512); ++i) {
+        if (name == GetSimdLevelName(static_cast<SimdLevel>(i))) {
+            level = static_cast<SimdLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Deterministic content, the kernels have no data dependent paths but the buffers should not be all zero
+void FillPattern(std::vector<uint8_t> &buffer)
+{
+    uint32_t state = 0x12345678u;
+    for (auto &byte : buffer) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+}
+
+template <typename Function>
+double MedianMicroseconds(uint32_t iterations, Function &&function)
+{
+    // The untimed first run faults the buffers in and lets the core settle at the clock it runs this code at
+    function();
+
+    std::vector<double> samples;
+    for (uint32_t i = 0; i < std::max(iterations, 1u); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+KernelAutotuner::KernelAutotuner(const KernelAutotunerConfig &config) : config_(config) {}
+
+bool KernelAutotuner::Run()
+{
+    bool saved = true;
+    if (config_.force || !LoadProfile(profile_)) {
+        profile_ = Calibrate();
+
+        if (!config_.profile_path.empty()) {
+            saved = SaveProfile(profile_);
+            if (!saved) {
+                LOG_WARN("Failed to save kernel profile to %s", config_.profile_path.c_str());
+            }
+        }
+    } else {
+        LOG_INFO("Kernel profile loaded from %s", config_.profile_path.c_str());
+    }
+
+    ApplyKernelProfile(profile_);
+    LOG_INFO("Kernels use %s (widest supported: %s)", GetSimdLevelName(GetSimdLevel()),
+             GetSimdLevelName(GetSupportedSimdLevel()));
+    for (size_t i = 0; i < profile_.resolutions.size(); ++i) {
+        LOG_INFO("  %ux%u: %u converter threads", profile_.resolutions[i].width, profile_.resolutions[i].height,
+                 profile_.resolutions[i].converter_threads);
+    }
+    return saved;
+}
+
+bool KernelAutotuner::LoadProfile(KernelProfile &profile) const
+{
+    if (config_.profile_path.empty()) {
+        return false;
+    }
+    std::ifstream file(config_.profile_path);
+    if (!file) {
+        return false;
+    }
+
+    KernelProfile loaded;
+    int version = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        auto equals = line.find('=');
+        if (equals == std::string::npos) {
+            LOG_WARN("Malformed kernel profile line: %s", line.c_str());
+            return false;
+        }
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+
+        if (key == "version") {
+            version = std::atoi(value.c_str());
+        } else if (key == "cpu") {
+            loaded.cpu_model = value;
+        } else if (key == "cpus") {
+            loaded.cpu_count = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "simd") {
+            if (!ParseSimdLevel(value, loaded.simd_level)) {
+                LOG_WARN("Unknown SIMD level in kernel profile: %s", value.c_str());
+                return false;
+            }
+        } else if (key.compare(0, 18, "converter_threads.") == 0) {
+            KernelProfile::Resolution resolution;
+            if (std::sscanf(key.c_str() + 18, "%ux%u", &resolution.width, &resolution.height) != 2) {
+                return false;
+            }
+            auto threads = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            resolution.converter_threads = std::max(threads, 1u);
+            loaded.resolutions.push_back(resolution);
+        }
+    }
+
+    if (version != PROFILE_VERSION || loaded.cpu_model != ReadCpuModel() ||
+        loaded.cpu_count != std::thread::hardware_concurrency() || loaded.simd_level > GetSupportedSimdLevel()) {
+        LOG_INFO("Kernel profile %s was measured on another host, recalibrating", config_.profile_path.c_str());
+        return false;
+    }
+    for (const auto &size : config_.resolutions) {
+        auto match = std::find_if(loaded.resolutions.begin(), loaded.resolutions.end(), [&](const auto &resolution) {
+            return resolution.width == size.first && resolution.height == size.second;
+        });
+        if (match == loaded.resolutions.end()) {
+            LOG_INFO("Kernel profile has no entry for %ux%u, recalibrating", size.first, size.second);
+            return false;
+        }
+    }
+
+    profile = loaded;
+    return true;
+}
+
+bool KernelAutotuner::SaveProfile(const KernelProfile &profile) const
+{
+    // Written next to the target and renamed, a crash never leaves a truncated profile behind
+    std::string temp_path = config_.profile_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << "# Kernel variants measured by KernelAutotuner, delete this file to recalibrate\n";
+        file << "version=" << PROFILE_VERSION << "\n";
+        file << "cpu=" << profile.cpu_model << "\n";
+        file << "cpus=" << profile.cpu_count << "\n";
+        file << "simd=" << GetSimdLevelName(profile.simd_level) << "\n";
+        for (const auto &resolution : profile.resolutions) {
+            file << "converter_threads." << resolution.width << "x" << resolution.height << "="
+                 << resolution.converter_threads << "\n";
+        }
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temp_path.c_str(), config_.profile_path.c_str()) == 0;
+}
+
+KernelProfile KernelAutotuner::Calibrate() const
+{
+    KernelProfile profile;
+    profile.cpu_model = ReadCpuModel();
+    profile.cpu_count = std::thread::hardware_concurrency();
+
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;
+    for (const auto &size : config_.resolutions) {
+        // Kernels work on 2x2 chroma blocks
+        uint32_t width = size.first & ~1u;
+        uint32_t height = size.second & ~1u;
+        if (width > 0 && height > 0) {
+            sizes.emplace_back(width, height);
+        }
+    }
+
+    // SIMD level: summed over all sizes so the choice fits the mix the host actually runs
+    const SimdLevel supported = GetSupportedSimdLevel();
+    double best_time = 0.0;
+    for (int i = static_cast<int>(SimdLevel::SCALAR); i <= static_cast<int>(supported); ++i) {
+        SimdLevel level = static_cast<SimdLevel>(i);
+        SetSimdLevel(level);
+        double time = 0.0;
+        for (const auto &size : sizes) {
+            time += TimeKernelMix(size.first, size.second);
+        }
+        LOG_DEBUG("Kernel mix with %s: %.0fus", GetSimdLevelName(level), time);
+        if (i == 0 || time < best_time * (1.0 - TIE_TOLERANCE)) {
+            best_time = time;
+            profile.simd_level = level;
+        }
+    }
+    SetSimdLevel(profile.simd_level);
+
+    // Converter bands, measured with the chosen SIMD level
+    uint32_t max_threads = config_.max_threads > 0 ? config_.max_threads : profile.cpu_count;
+    max_threads = std::clamp(max_threads, 1u, MAX_TUNED_THREADS);
+    for (size_t s = 0; s < config_.resolutions.size(); ++s) {
+        KernelProfile::Resolution resolution;
+        resolution.width = config_.resolutions[s].first;
+        resolution.height = config_.resolutions[s].second;
+
+        auto match = std::find_if(sizes.begin(), sizes.end(), [&](const auto &size) {
+            return size.first == (resolution.width & ~1u) && size.second == (resolution.height & ~1u);
+        });
+        if (match != sizes.end()) {
+            double best = 0.0;
+            for (uint32_t threads = 1; threads <= max_threads; ++threads) {
+                double time = TimeConverter(match->first, match->second, threads);
+                LOG_DEBUG("Converter %ux%u in %u bands: %.0fus", resolution.width, resolution.height, threads, time);
+                if (threads == 1 || time < best * (1.0 - TIE_TOLERANCE)) {
+                    best = time;
+                    resolution.converter_threads = threads;
+                }
+            }
+        }
+        profile.resolutions.push_back(resolution);
+    }
+    return profile;
+}
+
+double KernelAutotuner::TimeKernelMix(uint32_t width, uint32_t height) const
+{
+    const size_t pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> rgb(pixels * 4);
+    std::vector<uint8_t> packed(pixels * 4);
+    std::vector<uint8_t> yuv(pixels * 3 / 2);
+    FillPattern(rgb);
+
+    // What a frame goes through: capture unpacking, packed reordering, the scalar RGB -> YUV
+    // conversion that pays for any clock drop, and YUV -> RGB for preview and software decode
+    return MedianMicroseconds(config_.iterations, [&]() {
+        SwapX2Rgb10RedBlue(rgb.data(), packed.data(), pixels);
+        ConvertPackedRgb(FrameFormat::BGRA32, FrameFormat::RGBA32, rgb.data(), packed.data(), pixels);
+        ConvertPackedRgbToYuv(FrameFormat::BGRA32, FrameFormat::I420, rgb.data(), yuv.data(), width, height);
+        ConvertYuv420ToPackedRgb(FrameFormat::I420, FrameFormat::BGRA32, yuv.data(), packed.data(), width, height);
+    });
+}
+
+double KernelAutotuner::TimeConverter(uint32_t width, uint32_t height, uint32_t thread_count) const
+{
+    PixelFormatConverterConfig converter_config;
+    converter_config.input_format = FrameFormat::BGRA32;
+    converter_config.output_format = FrameFormat::I420;
+    converter_config.incremental = false;
+    converter_config.thread_count = thread_count;
+    PixelFormatConverter converter(converter_config);
+
+    const size_t size = static_cast<size_t>(width) * height * 4;
+    auto frame = std::make_shared<Frame>(size);
+    frame->SetSize(size);
+    frame->format = FrameFormat::BGRA32;
+    frame->width() = width;
+    frame->height() = height;
+    std::vector<uint8_t> pattern(size);
+    FillPattern(pattern);
+    std::copy(pattern.begin(), pattern.end(), frame->Data());
+
+    return MedianMicroseconds(config_.iterations, [&]() { converter.Process(frame); });
+}
+
+void ApplyKernelProfile(const KernelProfile &profile)
+{
+    SetSimdLevel(profile.simd_level);
+    std::lock_guard<std::mutex> lock(ActiveProfileMutex());
+    ActiveProfile() = profile;
+}
+
+uint32_t GetTunedConverterThreads(uint32_t width, uint32_t height)
+{
+    std::lock_guard<std::mutex> lock(ActiveProfileMutex());
+    for (const auto &resolution : ActiveProfile().resolutions) {
+        if (resolution.width == width && resolution.height == height) {
+            return resolution.converter_threads;
+        }
+    }
+    return 1;
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,112 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_KERNEL_AUTOTUNER_H
+#define LMSHAO_REMOTE_DESK_KERNEL_AUTOTUNER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "simd_support.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Kernel variants measured to be fastest on one host
+ */
+struct KernelProfile {
+    std::string cpu_model; // Profiles measured on another CPU are not reused
+    uint32_t cpu_count = 0;
+    SimdLevel simd_level = SimdLevel::SCALAR;
+
+    struct Resolution {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t converter_threads = 1; // PixelFormatConverterConfig::thread_count for this frame size
+    };
+    std::vector<Resolution> resolutions;
+};
+
+/**
+ * @brief Kernel autotuner configuration
+ */
+struct KernelAutotunerConfig {
+    std::string profile_path; // Where the profile is loaded from and saved to (empty = calibrate every start)
+    std::vector<std::pair<uint32_t, uint32_t>> resolutions{{1920, 1080}}; // Frame sizes the pipelines convert
+    uint32_t max_threads = 0; // Largest converter band count tried (0 = hardware concurrency, at most 8)
+    uint32_t iterations = 7;  // Timed runs per variant, the median counts
+    bool force = false;       // Calibrate even if a matching profile exists
+};
+
+/**
+ * @brief One-shot calibration of the pixel kernels on the actual host
+ * Times every SIMD level the CPU supports and every converter band count on
+ * frames of the configured sizes, picks the fastest and persists the result
+ * in a small text profile that later starts load instead of measuring again.
+ * The widest instruction set is not always the fastest: on many CPUs AVX-512
+ * lowers the core clock, which also slows the scalar RGB -> YUV conversion
+ * running next to it, so every level is timed on a mix of SIMD and scalar
+ * kernels rather than on its own kernel.
+ * Run it before any pipeline starts, calibration switches the process-wide
+ * SIMD level while it measures.
+ */
+class KernelAutotuner {
+public:
+    explicit KernelAutotuner(const KernelAutotunerConfig &config = {});
+
+    /**
+     * @brief Load a matching profile or calibrate and save one, then apply it
+     * @return false if calibration was needed and the profile could not be saved (it is applied anyway)
+     */
+    bool Run();
+
+    /**
+     * @brief Profile applied by the last Run()
+     */
+    const KernelProfile &GetProfile() const { return profile_; }
+
+private:
+    /**
+     * @brief Read a profile written by SaveProfile(), false if missing, malformed or from another host
+     */
+    bool LoadProfile(KernelProfile &profile) const;
+
+    bool SaveProfile(const KernelProfile &profile) const;
+
+    KernelProfile Calibrate() const;
+
+    /**
+     * @brief Median time in microseconds of one frame of the kernel mix at the current SIMD level
+     */
+    double TimeKernelMix(uint32_t width, uint32_t height) const;
+
+    /**
+     * @brief Median time in microseconds of a whole-frame RGB -> I420 conversion in thread_count bands
+     */
+    double TimeConverter(uint32_t width, uint32_t height, uint32_t thread_count) const;
+
+private:
+    KernelAutotunerConfig config_;
+    KernelProfile profile_;
+};
+
+/**
+ * @brief Make a profile the one consulted by the kernels and converters
+ */
+void ApplyKernelProfile(const KernelProfile &profile);
+
+/**
+ * @brief Converter band count of the applied profile for a frame size, 1 if it was not tuned
+ */
+uint32_t GetTunedConverterThreads(uint32_t width, uint32_t height);
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_KERNEL_AUTOTUNER_H
@@ -0,0 +1,95 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "keyframe_arbiter.h"
+
+#include <algorithm>
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+KeyframeArbiter::KeyframeArbiter(const KeyframeArbiterConfig &config) : config_(config) {}
+
+std::optional<std::chrono::milliseconds> KeyframeArbiter::Request(const std::string &client_id,
+                                                                  Clock::time_point now, KeyframeRequestReason reason)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.requests++;
+
+    // A running intra refresh wave heals a lossy client within its duration anyway, but never gives a
+    // client without references a point to start decoding from
+    if (reason == KeyframeRequestReason::LOSS && now < intra_refresh_until_) {
+        stats_.requests_coalesced++;
+        return std::nullopt;
+    }
+
+    pending_clients_.insert(client_id);
+    if (reason == KeyframeRequestReason::FULL_REFRESH) {
+        full_refresh_pending_ = true;
+    }
+    if (resolve_scheduled_) {
+        stats_.requests_coalesced++;
+        return std::nullopt;
+    }
+
+    resolve_scheduled_ = true;
+    auto earliest = last_recovery_time_ + config_.min_recovery_interval;
+    auto delay = std::max(config_.coalesce_window,
+                          std::chrono::duration_cast<std::chrono::milliseconds>(earliest - now));
+    return delay;
+}
+
+KeyframeArbiter::Decision KeyframeArbiter::Resolve(Clock::time_point now, bool long_term_reference_available,
+                                                   bool intra_refresh_available)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolve_scheduled_ = false;
+
+    Decision decision;
+    decision.clients = pending_clients_.size();
+    bool full_refresh = full_refresh_pending_;
+    pending_clients_.clear();
+    full_refresh_pending_ = false;
+    if (decision.clients == 0) {
+        return decision;
+    }
+
+    if (full_refresh) {
+        decision.action = RecoveryAction::KEYFRAME;
+        stats_.keyframes++;
+    } else if (long_term_reference_available) {
+        decision.action = RecoveryAction::LONG_TERM_REFERENCE;
+        stats_.long_term_recoveries++;
+    } else if (intra_refresh_available && decision.clients >= config_.intra_refresh_min_clients) {
+        decision.action = RecoveryAction::INTRA_REFRESH;
+        intra_refresh_until_ = now + config_.intra_refresh_duration;
+        stats_.intra_refreshes++;
+    } else {
+        decision.action = RecoveryAction::KEYFRAME;
+        stats_.keyframes++;
+    }
+
+    last_recovery_time_ = now;
+    LOG_DEBUG("Keyframe arbiter: action %d for %zu clients", static_cast<int>(decision.action), decision.clients);
+    return decision;
+}
+
+void KeyframeArbiter::RemoveClient(const std::string &client_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_clients_.erase(client_id);
+}
+
+KeyframeArbiter::ArbiterStats KeyframeArbiter::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,113 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_KEYFRAME_ARBITER_H
+#define LMSHAO_REMOTE_DESK_KEYFRAME_ARBITER_H
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Keyframe arbiter configuration
+ */
+struct KeyframeArbiterConfig {
+    std::chrono::milliseconds coalesce_window{40};          // Requests within this window are merged
+    std::chrono::milliseconds min_recovery_interval{500};   // At most one recovery per interval
+    std::chrono::milliseconds intra_refresh_duration{1000}; // Requests during a running wave are absorbed
+    uint32_t intra_refresh_min_clients = 3;                 // Clients in one batch that switch to intra refresh
+};
+
+/**
+ * @brief Recovery chosen for a batch of keyframe requests, cheapest first
+ */
+enum class RecoveryAction {
+    NONE,                // Nothing pending, or already healed by a running intra refresh wave
+    LONG_TERM_REFERENCE, // Predict from a reference acknowledged by every client
+    INTRA_REFRESH,       // Spread intra blocks over the next frames instead of one large IDR
+    KEYFRAME             // Full IDR
+};
+
+/**
+ * @brief Why a client asked for a keyframe
+ */
+enum class KeyframeRequestReason {
+    LOSS,        // PLI or loss report: the client keeps its references, any recovery that repairs them will do
+    FULL_REFRESH // FIR, new client or decoder reset: the client has no usable reference, only an IDR serves it
+};
+
+/**
+ * @brief Merges keyframe requests (PLI/FIR, loss reports) from all clients of a shared encoder
+ * The first request of a batch opens a coalescing window; requests arriving
+ * inside it join the batch. The batch is resolved when the window closes, or
+ * when the minimum interval since the previous recovery has passed, whichever
+ * is later. Each batch produces at most one recovery for all of its clients;
+ * a batch holding a FULL_REFRESH request always resolves to a keyframe.
+ * The arbiter only decides; VideoEncoder calls Resolve() on the first frame
+ * after the delay returned by Request() and applies the action to that frame.
+ */
+class KeyframeArbiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Decision {
+        RecoveryAction action = RecoveryAction::NONE;
+        size_t clients = 0; // Clients served by this decision
+    };
+
+    explicit KeyframeArbiter(const KeyframeArbiterConfig &config = {});
+
+    /**
+     * @brief Add a client's request to the pending batch
+     * @return Delay after which Resolve() must be called if this request opened a new batch,
+     *         std::nullopt if a resolution is already scheduled or the request was absorbed
+     */
+    std::optional<std::chrono::milliseconds> Request(const std::string &client_id, Clock::time_point now,
+                                                     KeyframeRequestReason reason);
+
+    /**
+     * @brief Close the pending batch and pick the cheapest recovery that serves it
+     * @param long_term_reference_available The encoder has a reference confirmed by every client
+     * @param intra_refresh_available The encoder was opened with intra refresh
+     * Both only apply to batches of LOSS requests.
+     */
+    Decision Resolve(Clock::time_point now, bool long_term_reference_available, bool intra_refresh_available);
+
+    /**
+     * @brief Forget a disconnected client's pending request
+     */
+    void RemoveClient(const std::string &client_id);
+
+    struct ArbiterStats {
+        uint64_t requests = 0;
+        uint64_t requests_coalesced = 0; // Joined a pending batch or absorbed by a running wave
+        uint64_t long_term_recoveries = 0;
+        uint64_t intra_refreshes = 0;
+        uint64_t keyframes = 0;
+    };
+    ArbiterStats GetStats() const;
+
+private:
+    KeyframeArbiterConfig config_;
+
+    mutable std::mutex mutex_;
+    std::set<std::string> pending_clients_;
+    bool full_refresh_pending_ = false; // The pending batch holds a FULL_REFRESH request
+    bool resolve_scheduled_ = false;
+    Clock::time_point last_recovery_time_{};
+    Clock::time_point intra_refresh_until_{};
+    ArbiterStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_KEYFRAME_ARBITER_H
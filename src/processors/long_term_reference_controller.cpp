@@ -0,0 +1,184 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "long_term_reference_controller.h"
+
+#include <algorithm>
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+LongTermReferenceController::LongTermReferenceController(uint8_t temporal_layers, uint32_t refresh_interval)
+    : refresh_interval_(std::max(1u, refresh_interval))
+{
+    slots_.resize(temporal_layers < 3 ? 2 : 1);
+    slots_[0].no_ref_flag = VpxRefFlags::NO_REF_ARF;
+    slots_[0].no_upd_flag = VpxRefFlags::NO_UPD_ARF;
+    if (slots_.size() > 1) {
+        slots_[1].no_ref_flag = VpxRefFlags::NO_REF_GF;
+        slots_[1].no_upd_flag = VpxRefFlags::NO_UPD_GF;
+    }
+}
+
+void LongTermReferenceController::AddReceiver(const std::string &receiver_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    receivers_.insert(receiver_id);
+    UpdateConfirmedLocked();
+}
+
+void LongTermReferenceController::RemoveReceiver(const std::string &receiver_id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    receivers_.erase(receiver_id);
+    for (auto &slot : slots_) {
+        slot.acked_by.erase(receiver_id);
+    }
+    UpdateConfirmedLocked();
+}
+
+void LongTermReferenceController::OnReferenceAcknowledged(const std::string &receiver_id, int64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &slot : slots_) {
+        if (slot.timestamp == timestamp) {
+            slot.acked_by.insert(receiver_id);
+        }
+    }
+    UpdateConfirmedLocked();
+}
+
+bool LongTermReferenceController::RequestRecovery()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    recovery_slot_ = NewestConfirmedSlotLocked();
+    if (recovery_slot_ < 0) {
+        stats_.recoveries_refused++;
+        return false;
+    }
+    LOG_DEBUG("Loss recovery from long-term reference %lld",
+              static_cast<long long>(slots_[recovery_slot_].timestamp));
+    return true;
+}
+
+bool LongTermReferenceController::HasConfirmedReference() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return NewestConfirmedSlotLocked() >= 0;
+}
+
+bool LongTermReferenceController::ApplyToFrame(TemporalLayerStructure::FrameConfig &frame, int64_t timestamp,
+                                               bool keyframe)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (keyframe) {
+        ResetSlotsLocked(timestamp);
+        frame.long_term_reference = true;
+        return false;
+    }
+
+    if (recovery_slot_ >= 0) {
+        // Reference only the confirmed slot and restart the short-term chain from this frame
+        const Slot &slot = slots_[recovery_slot_];
+        frame.temporal_id = 0;
+        frame.vpx_flags = (VpxRefFlags::NO_REF_LAST | VpxRefFlags::NO_REF_GF | VpxRefFlags::NO_REF_ARF |
+                           VpxRefFlags::NO_UPD_GF | VpxRefFlags::NO_UPD_ARF) &
+                          ~slot.no_ref_flag;
+        recovery_slot_ = -1;
+        stats_.recoveries++;
+        return true;
+    }
+
+    // The slots hold long-term frames only; every other frame must leave them untouched, including
+    // single layer frames whose pattern flags are 0 (update all buffers)
+    for (const auto &slot : slots_) {
+        frame.vpx_flags |= slot.no_upd_flag;
+    }
+
+    if (frame.temporal_id != 0 || ++frames_since_refresh_ < refresh_interval_) {
+        return false;
+    }
+
+    size_t target = 0;
+    if (slots_.size() == 1) {
+        // Overwriting the lone slot before it is confirmed would leave nothing to recover from
+        if (slots_[0].timestamp >= 0 && !slots_[0].confirmed) {
+            return false;
+        }
+    } else {
+        // Keep the newest confirmed slot, or the newest pending one while nothing is confirmed
+        int keep = NewestConfirmedSlotLocked();
+        if (keep < 0) {
+            keep = slots_[0].timestamp >= slots_[1].timestamp ? 0 : 1;
+        }
+        target = keep == 0 ? 1 : 0;
+    }
+
+    Slot &slot = slots_[target];
+    slot.timestamp = timestamp;
+    slot.acked_by.clear();
+    slot.confirmed = false;
+    frame.vpx_flags &= ~slot.no_upd_flag;
+    frame.long_term_reference = true;
+    frames_since_refresh_ = 0;
+    stats_.references_marked++;
+    return false;
+}
+
+void LongTermReferenceController::OnKeyframe(int64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ResetSlotsLocked(timestamp);
+}
+
+LongTermReferenceController::ReferenceStats LongTermReferenceController::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void LongTermReferenceController::UpdateConfirmedLocked()
+{
+    for (auto &slot : slots_) {
+        bool confirmed =
+            slot.timestamp >= 0 && !receivers_.empty() &&
+            std::includes(slot.acked_by.begin(), slot.acked_by.end(), receivers_.begin(), receivers_.end());
+        if (confirmed && !slot.confirmed) {
+            stats_.references_confirmed++;
+        }
+        slot.confirmed = confirmed;
+    }
+}
+
+void LongTermReferenceController::ResetSlotsLocked(int64_t timestamp)
+{
+    // A keyframe refreshes every reference buffer
+    for (auto &slot : slots_) {
+        slot.timestamp = timestamp;
+        slot.acked_by.clear();
+        slot.confirmed = false;
+    }
+    recovery_slot_ = -1;
+    frames_since_refresh_ = 0;
+    stats_.references_marked++;
+}
+
+int LongTermReferenceController::NewestConfirmedSlotLocked() const
+{
+    int newest = -1;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        if (slots_[i].confirmed && (newest < 0 || slots_[i].timestamp > slots_[newest].timestamp)) {
+            newest = static_cast<int>(i);
+        }
+    }
+    return newest;
+}
+
+} // namespace lmshao::remotedesk
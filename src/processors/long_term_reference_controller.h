@@ -0,0 +1,124 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_LONG_TERM_REFERENCE_CONTROLLER_H
+#define LMSHAO_REMOTE_DESK_LONG_TERM_REFERENCE_CONTROLLER_H
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "temporal_layer_structure.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Long-term reference (LTR) bookkeeping for loss recovery without keyframes
+ * Every refresh_interval base layer frames one frame is additionally stored in
+ * a long-term slot (libvpx GOLDEN/ALTREF buffer). Receivers acknowledge the
+ * long-term frames they decoded, identified by frame timestamp. A slot is
+ * confirmed once every registered receiver acknowledged it. On loss the next
+ * frame is predicted from the newest confirmed slot only, which every receiver
+ * can decode, and costs a fraction of a keyframe.
+ *
+ * Acknowledgements come from the RTCP handling of each receiver, through the
+ * controller returned by VideoEncoder::GetLongTermReferenceController().
+ *
+ * Two slots are used so that refreshing one never discards the confirmed one.
+ * With three temporal layers GOLDEN belongs to TL1 and only ALTREF is left; the
+ * slot is then refreshed only after its previous content was confirmed.
+ */
+class LongTermReferenceController {
+public:
+    /**
+     * @param temporal_layers Layer count of the TemporalLayerStructure in use
+     * @param refresh_interval Base layer frames between long-term frames
+     */
+    LongTermReferenceController(uint8_t temporal_layers, uint32_t refresh_interval);
+
+    /**
+     * @brief Receivers whose acknowledgements are required to confirm a slot
+     */
+    void AddReceiver(const std::string &receiver_id);
+    void RemoveReceiver(const std::string &receiver_id);
+
+    /**
+     * @brief A receiver decoded the long-term frame with this timestamp
+     */
+    void OnReferenceAcknowledged(const std::string &receiver_id, int64_t timestamp);
+
+    /**
+     * @brief Predict the next frame from the newest confirmed slot
+     * @return false if no slot is confirmed, the caller must force a keyframe instead
+     */
+    bool RequestRecovery();
+
+    /**
+     * @brief Whether RequestRecovery() would succeed now
+     */
+    bool HasConfirmedReference() const;
+
+    /**
+     * @brief Adjust the reference flags of the next frame in encode order
+     * @param keyframe The frame is encoded as a keyframe (refreshes every slot)
+     * @return true if this is the recovery frame, the temporal pattern should restart after it
+     */
+    bool ApplyToFrame(TemporalLayerStructure::FrameConfig &frame, int64_t timestamp, bool keyframe);
+
+    /**
+     * @brief The encoder emitted a keyframe that ApplyToFrame() was not told about
+     * Every slot now holds that frame and waits for new acknowledgements.
+     */
+    void OnKeyframe(int64_t timestamp);
+
+    struct ReferenceStats {
+        uint64_t references_marked = 0;
+        uint64_t references_confirmed = 0;
+        uint64_t recoveries = 0;
+        uint64_t recoveries_refused = 0; // RequestRecovery() without a confirmed slot
+    };
+    ReferenceStats GetStats() const;
+
+private:
+    struct Slot {
+        uint32_t no_ref_flag = 0;
+        uint32_t no_upd_flag = 0;
+        int64_t timestamp = -1; // Frame held by the slot, -1 if empty
+        std::set<std::string> acked_by;
+        bool confirmed = false;
+    };
+
+    /**
+     * @brief Re-evaluate the confirmed state of every slot (mutex_ held)
+     */
+    void UpdateConfirmedLocked();
+
+    /**
+     * @brief Store a keyframe in every slot (mutex_ held)
+     */
+    void ResetSlotsLocked(int64_t timestamp);
+
+    /**
+     * @brief Index of the confirmed slot holding the newest frame, -1 if none (mutex_ held)
+     */
+    int NewestConfirmedSlotLocked() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    std::set<std::string> receivers_;
+    uint32_t refresh_interval_;
+    uint32_t frames_since_refresh_ = 0;
+    int recovery_slot_ = -1;
+    ReferenceStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_LONG_TERM_REFERENCE_CONTROLLER_H
@@ -0,0 +1,349 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "mjpeg_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+AVPixelFormat ToAVPixelFormat(FrameFormat format)
+{
+    switch (format) {
+        case FrameFormat::I420:
+            return AV_PIX_FMT_YUV420P;
+        case FrameFormat::BGRA32:
+            return AV_PIX_FMT_BGRA;
+        case FrameFormat::RGBA32:
+            return AV_PIX_FMT_RGBA;
+        case FrameFormat::RGB24:
+            return AV_PIX_FMT_RGB24;
+        case FrameFormat::BGR24:
+            return AV_PIX_FMT_BGR24;
+        default:
+            return AV_PIX_FMT_NONE;
+    }
+}
+
+uint32_t BytesPerPixel(FrameFormat format)
+{
+    switch (format) {
+        case FrameFormat::RGB24:
+        case FrameFormat::BGR24:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+} // namespace
+
+MjpegEncoder::MjpegEncoder(const MjpegEncoderConfig &config) : config_(config)
+{
+    LOG_DEBUG("MjpegEncoder created with quality=%u, slices=%u, threads=%u", config_.quality, config_.slice_count,
+              config_.thread_count);
+}
+
+MjpegEncoder::~MjpegEncoder()
+{
+    Cleanup();
+    LOG_DEBUG("MjpegEncoder destroyed");
+}
+
+bool MjpegEncoder::Initialize()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (config_.quality == 0 || config_.quality > 100) {
+        LOG_ERROR("Invalid JPEG quality %u (expected 1-100)", config_.quality);
+        return false;
+    }
+
+    codec_ = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+    if (!codec_) {
+        LOG_ERROR("MJPEG encoder not available in this FFmpeg build");
+        return false;
+    }
+
+    // The codec context is opened lazily on the first frame, when the input size is known
+    initialized_ = true;
+    LOG_INFO("MjpegEncoder initialized successfully");
+    return true;
+}
+
+void MjpegEncoder::Cleanup()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CloseCodec();
+    initialized_ = false;
+}
+
+bool MjpegEncoder::IsReady() const
+{
+    return initialized_;
+}
+
+bool MjpegEncoder::SetQuality(uint32_t quality)
+{
+    if (quality == 0 || quality > 100) {
+        LOG_ERROR("Invalid JPEG quality %u (expected 1-100)", quality);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    LOG_INFO("Setting JPEG quality from %u to %u", config_.quality, quality);
+    config_.quality = quality;
+    if (codec_ctx_) {
+        codec_ctx_->global_quality = QualityToQscale(quality) * FF_QP2LAMBDA;
+    }
+    return true;
+}
+
+MjpegEncoderConfig MjpegEncoder::GetConfig() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+void MjpegEncoder::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    if (!frame || !frame->IsValid() || !frame->IsVideo() || !initialized_) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.frames_dropped++;
+        return;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Frame>> outputs;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!codec_ctx_ || codec_ctx_->width != frame->width() || codec_ctx_->height != frame->height()) {
+            CloseCodec();
+            if (!OpenCodec(frame->width(), frame->height())) {
+                std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                stats_.frames_dropped++;
+                return;
+            }
+        }
+
+        if (!FillPicture(frame)) {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.frames_dropped++;
+            return;
+        }
+
+        picture_->pts = frame_count_++;
+        picture_->quality = codec_ctx_->global_quality;
+
+        int ret = avcodec_send_frame(codec_ctx_, picture_);
+        if (ret < 0) {
+            LOG_ERROR("avcodec_send_frame failed: %d", ret);
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.frames_dropped++;
+            return;
+        }
+
+        while ((ret = avcodec_receive_packet(codec_ctx_, packet_)) >= 0) {
+            auto output = std::make_shared<Frame>(static_cast<size_t>(packet_->size));
+            output->SetSize(packet_->size);
+            std::memcpy(output->Data(), packet_->data, packet_->size);
+            output->format = FrameFormat::MJPEG;
+            output->timestamp = frame->timestamp;
+            output->width() = frame->width();
+            output->height() = frame->height();
+            output->video_info.framerate = config_.fps;
+            output->video_info.is_keyframe = true; // Every JPEG picture is independently decodable
+            outputs.push_back(output);
+            av_packet_unref(packet_);
+        }
+    }
+
+    auto encode_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+
+    // Deliver outside the encoder lock so slow sinks never block quality updates
+    for (auto &output : outputs) {
+        UpdateStats(output->Size(), output->width(), output->height(), encode_time);
+        DeliverFrame(output);
+    }
+}
+
+bool MjpegEncoder::OpenCodec(uint32_t width, uint32_t height)
+{
+    if (!codec_) {
+        return false;
+    }
+
+    codec_ctx_ = avcodec_alloc_context3(codec_);
+    if (!codec_ctx_) {
+        LOG_ERROR("Failed to allocate MJPEG codec context");
+        return false;
+    }
+
+    uint32_t threads = config_.thread_count;
+    if (threads == 0) {
+        threads = std::max(1u, std::min(std::thread::hardware_concurrency(), 8u));
+    }
+
+    codec_ctx_->width = static_cast<int>(width);
+    codec_ctx_->height = static_cast<int>(height);
+    codec_ctx_->time_base = {1, static_cast<int>(std::max(1u, config_.fps))};
+    codec_ctx_->framerate = {static_cast<int>(std::max(1u, config_.fps)), 1};
+    codec_ctx_->pix_fmt = AV_PIX_FMT_YUVJ420P; // Full range, matches PixelFormatConverter output
+    codec_ctx_->flags |= AV_CODEC_FLAG_QSCALE;
+    codec_ctx_->global_quality = QualityToQscale(config_.quality) * FF_QP2LAMBDA;
+    codec_ctx_->qmin = 2;
+    codec_ctx_->qmax = 31;
+
+    // Slice threading: each worker compresses an independent band of MCU rows
+    codec_ctx_->thread_type = FF_THREAD_SLICE;
+    codec_ctx_->thread_count = static_cast<int>(threads);
+    codec_ctx_->slices = static_cast<int>(config_.slice_count > 0 ? config_.slice_count : threads);
+
+    int ret = avcodec_open2(codec_ctx_, codec_, nullptr);
+    if (ret < 0) {
+        LOG_ERROR("Failed to open MJPEG encoder for %ux%u: %d", width, height, ret);
+        avcodec_free_context(&codec_ctx_);
+        return false;
+    }
+
+    picture_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (!picture_ || !packet_) {
+        LOG_ERROR("Failed to allocate MJPEG frame/packet");
+        CloseCodec();
+        return false;
+    }
+
+    picture_->format = codec_ctx_->pix_fmt;
+    picture_->width = codec_ctx_->width;
+    picture_->height = codec_ctx_->height;
+    if (av_frame_get_buffer(picture_, 32) < 0) {
+        LOG_ERROR("Failed to allocate MJPEG picture buffer");
+        CloseCodec();
+        return false;
+    }
+
+    frame_count_ = 0;
+    LOG_INFO("MJPEG encoder opened: %ux%u, %d threads, %d slices, quality=%u", width, height,
+             codec_ctx_->thread_count, codec_ctx_->slices, config_.quality);
+    return true;
+}
+
+void MjpegEncoder::CloseCodec()
+{
+    if (sws_ctx_) {
+        sws_freeContext(sws_ctx_);
+        sws_ctx_ = nullptr;
+    }
+    if (packet_) {
+        av_packet_free(&packet_);
+    }
+    if (picture_) {
+        av_frame_free(&picture_);
+    }
+    if (codec_ctx_) {
+        avcodec_free_context(&codec_ctx_);
+    }
+}
+
+bool MjpegEncoder::FillPicture(const std::shared_ptr<Frame> &input)
+{
+    AVPixelFormat src_format = ToAVPixelFormat(input->format);
+    if (src_format == AV_PIX_FMT_NONE) {
+        LOG_ERROR("Unsupported input format %d for MJPEG encoding", static_cast<int>(input->format));
+        return false;
+    }
+
+    if (av_frame_make_writable(picture_) < 0) {
+        LOG_ERROR("MJPEG picture buffer is not writable");
+        return false;
+    }
+
+    int width = input->width();
+    int height = input->height();
+
+    if (input->format == FrameFormat::I420) {
+        // Planar input already matches the encoder layout, copy planes directly. Odd sizes round the
+        // chroma planes up, like av_image_fill_arrays() does.
+        size_t luma_size = static_cast<size_t>(width) * height;
+        int chroma_width = (width + 1) / 2;
+        size_t chroma_size = static_cast<size_t>(chroma_width) * ((height + 1) / 2);
+        if (input->Size() < luma_size + 2 * chroma_size) {
+            LOG_ERROR("I420 frame of %zu bytes is too small for %dx%d", input->Size(), width, height);
+            return false;
+        }
+        const uint8_t *src_data[4] = {input->data(), input->data() + luma_size,
+                                      input->data() + luma_size + chroma_size, nullptr};
+        const int src_linesize[4] = {width, chroma_width, chroma_width, 0};
+        av_image_copy(picture_->data, picture_->linesize, src_data, src_linesize, AV_PIX_FMT_YUV420P, width, height);
+        return true;
+    }
+
+    sws_ctx_ = sws_getCachedContext(sws_ctx_, width, height, src_format, width, height, AV_PIX_FMT_YUVJ420P,
+                                    SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!sws_ctx_) {
+        LOG_ERROR("Failed to create colour conversion context for MJPEG");
+        return false;
+    }
+
+    int row_size = width * static_cast<int>(BytesPerPixel(input->format));
+    int stride = input->stride > 0 ? static_cast<int>(input->stride) : row_size;
+    if (stride < row_size || input->Size() < static_cast<size_t>(stride) * (height - 1) + row_size) {
+        LOG_ERROR("Frame of %zu bytes with stride %d is too small for %dx%d", input->Size(), stride, width, height);
+        return false;
+    }
+
+    const uint8_t *src_data[1] = {input->data()};
+    const int src_linesize[1] = {stride};
+    sws_scale(sws_ctx_, src_data, src_linesize, 0, height, picture_->data, picture_->linesize);
+    return true;
+}
+
+int MjpegEncoder::QualityToQscale(uint32_t quality)
+{
+    quality = std::clamp(quality, 1u, 100u);
+    // quality 100 -> qscale 2 (finest), quality 1 -> qscale 31 (coarsest)
+    return 2 + static_cast<int>((100 - quality) * 29 / 99);
+}
+
+void MjpegEncoder::UpdateStats(size_t encoded_size, uint32_t width, uint32_t height,
+                               std::chrono::milliseconds encode_time)
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+
+    stats_.frames_encoded++;
+    stats_.total_bytes_encoded += encoded_size;
+    stats_.width = width;
+    stats_.height = height;
+
+    // Exponential moving average, same weighting as VideoScaler
+    if (stats_.frames_encoded == 1) {
+        stats_.avg_encode_time = encode_time;
+    } else {
+        auto new_avg = stats_.avg_encode_time.count() * 0.9 + encode_time.count() * 0.1;
+        stats_.avg_encode_time = std::chrono::milliseconds(static_cast<long long>(new_avg));
+    }
+}
+
+MjpegEncoder::EncodeStats MjpegEncoder::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,124 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_MJPEG_ENCODER_H
+#define LMSHAO_REMOTE_DESK_MJPEG_ENCODER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "../core/media_processor.h"
+
+// FFmpeg headers
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief MJPEG encoder configuration
+ */
+struct MjpegEncoderConfig {
+    uint32_t fps = 15;
+    uint32_t quality = 75;     // JPEG quality 1-100, higher is better
+    uint32_t slice_count = 0;  // Number of slices encoded in parallel (0 = one per thread)
+    uint32_t thread_count = 0; // Encoder worker threads (0 = auto-detect)
+};
+
+/**
+ * @brief MJPEG encoder - encodes raw video frames to baseline JPEG pictures
+ * Intended for low-CPU clients that cannot decode H264. Every output frame is
+ * an independent keyframe, so it works with any number of viewers without
+ * keyframe requests. Encoding runs synchronously in OnFrame, slices are
+ * compressed in parallel by libavcodec worker threads.
+ */
+class MjpegEncoder : public MediaProcessor {
+public:
+    explicit MjpegEncoder(const MjpegEncoderConfig &config = {});
+    ~MjpegEncoder() override;
+
+    // MediaProcessor interface implementation
+    bool Initialize() override;
+    void Cleanup() override;
+    bool IsReady() const override;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+
+    /**
+     * @brief Dynamically adjust JPEG quality (1-100)
+     */
+    bool SetQuality(uint32_t quality);
+
+    /**
+     * @brief Get current configuration
+     */
+    MjpegEncoderConfig GetConfig() const;
+
+    /**
+     * @brief Get encoding statistics
+     */
+    struct EncodeStats {
+        uint64_t frames_encoded = 0;
+        uint64_t frames_dropped = 0;
+        uint64_t total_bytes_encoded = 0;
+        std::chrono::milliseconds avg_encode_time{0};
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+    EncodeStats GetStats() const;
+
+private:
+    /**
+     * @brief Open the libavcodec MJPEG encoder for the given input size
+     */
+    bool OpenCodec(uint32_t width, uint32_t height);
+
+    /**
+     * @brief Release libavcodec resources
+     */
+    void CloseCodec();
+
+    /**
+     * @brief Copy or convert the input frame into the encoder picture
+     */
+    bool FillPicture(const std::shared_ptr<Frame> &input);
+
+    /**
+     * @brief Map JPEG quality (1-100) to an MPEG quantizer scale (2-31)
+     */
+    static int QualityToQscale(uint32_t quality);
+
+    /**
+     * @brief Update statistics
+     */
+    void UpdateStats(size_t encoded_size, uint32_t width, uint32_t height, std::chrono::milliseconds encode_time);
+
+private:
+    MjpegEncoderConfig config_;
+    mutable std::mutex mutex_;
+    std::atomic<bool> initialized_{false};
+
+    // FFmpeg related
+    const AVCodec *codec_ = nullptr;
+    AVCodecContext *codec_ctx_ = nullptr;
+    AVFrame *picture_ = nullptr;
+    AVPacket *packet_ = nullptr;
+    SwsContext *sws_ctx_ = nullptr;
+    int64_t frame_count_ = 0;
+
+    // Statistics
+    mutable std::mutex stats_mutex_;
+    EncodeStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_MJPEG_ENCODER_H
@@ -0,0 +1,660 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "packed_rgb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+//==============================================================================
+// Packed RGB -> packed RGB
+//==============================================================================
+
+template <FrameFormat Src, FrameFormat Dst>
+struct PackedRgbKernel {
+    using S = PackedRgbTraits<Src>;
+    using D = PackedRgbTraits<Dst>;
+
+    static constexpr int SBPP = S::BYTES_PER_PIXEL;
+    static constexpr int DBPP = D::BYTES_PER_PIXEL;
+    static constexpr bool FILL_ALPHA = D::ALPHA >= 0 && S::ALPHA < 0;
+
+    // Whole pixels per 16-byte lane, limited by whichever side is wider
+    static constexpr int LANE_PIXELS = 16 / (SBPP > DBPP ? SBPP : DBPP);
+
+    // Source byte feeding destination byte c of a pixel, -1 for a filled alpha byte
+    static constexpr int SourceOffset(int c)
+    {
+        if (c == D::RED) {
+            return S::RED;
+        }
+        if (c == D::GREEN) {
+            return S::GREEN;
+        }
+        if (c == D::BLUE) {
+            return S::BLUE;
+        }
+        return S::ALPHA;
+    }
+
+    static constexpr std::array<int8_t, 16> ShuffleMask()
+    {
+        std::array<int8_t, 16> mask{};
+        for (int i = 0; i < 16; ++i) {
+            int pixel = i / DBPP;
+            int offset = SourceOffset(i % DBPP);
+            mask[i] = (pixel < LANE_PIXELS && offset >= 0) ? static_cast<int8_t>(pixel * SBPP + offset) : -1;
+        }
+        return mask;
+    }
+
+    static constexpr std::array<int8_t, 16> AlphaMask()
+    {
+        std::array<int8_t, 16> mask{};
+        for (int i = 0; i < 16; ++i) {
+            mask[i] = (FILL_ALPHA && i / DBPP < LANE_PIXELS && i % DBPP == D::ALPHA) ? -1 : 0;
+        }
+        return mask;
+    }
+
+    static void Scalar(const uint8_t *src, uint8_t *dst, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            const uint8_t *s = src + i * SBPP;
+            uint8_t *d = dst + i * DBPP;
+            d[D::RED] = s[S::RED];
+            d[D::GREEN] = s[S::GREEN];
+            d[D::BLUE] = s[S::BLUE];
+            if constexpr (FILL_ALPHA) {
+                d[D::ALPHA] = 255;
+            } else if constexpr (D::ALPHA >= 0) {
+                d[D::ALPHA] = s[S::ALPHA];
+            }
+        }
+    }
+
+#ifdef REMOTE_DESK_X86_SIMD
+    // Every 16-byte load and store stays inside the buffers, the tail is finished by Scalar
+    REMOTE_DESK_TARGET_SSSE3 static size_t Ssse3(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+    {
+        static constexpr auto SHUFFLE = ShuffleMask();
+        static constexpr auto ALPHA = AlphaMask();
+        const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(SHUFFLE.data()));
+        const __m128i alpha = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ALPHA.data()));
+
+        const size_t src_bytes = pixel_count * SBPP;
+        const size_t dst_bytes = pixel_count * DBPP;
+        size_t i = 0;
+        for (; i * SBPP + 16 <= src_bytes && i * DBPP + 16 <= dst_bytes; i += LANE_PIXELS) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * SBPP));
+            v = _mm_shuffle_epi8(v, shuffle);
+            if constexpr (FILL_ALPHA) {
+                v = _mm_or_si128(v, alpha);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * DBPP), v);
+        }
+        return i;
+    }
+
+    // vpshufb shuffles within 128-bit lanes, so each lane carries its own LANE_PIXELS pixels
+    REMOTE_DESK_TARGET_AVX2 static size_t Avx2(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+    {
+        static constexpr auto SHUFFLE = ShuffleMask();
+        static constexpr auto ALPHA = AlphaMask();
+        const __m256i shuffle =
+            _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(SHUFFLE.data())));
+        const __m256i alpha =
+            _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ALPHA.data())));
+
+        const size_t src_bytes = pixel_count * SBPP;
+        const size_t dst_bytes = pixel_count * DBPP;
+        size_t i = 0;
+        for (; (i + LANE_PIXELS) * SBPP + 16 <= src_bytes && (i + LANE_PIXELS) * DBPP + 16 <= dst_bytes;
+             i += 2 * LANE_PIXELS) {
+            __m256i v;
+            if constexpr (LANE_PIXELS * SBPP == 16) {
+                v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * SBPP));
+            } else {
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * SBPP));
+                __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (i + LANE_PIXELS) * SBPP));
+                v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            }
+
+            v = _mm256_shuffle_epi8(v, shuffle);
+            if constexpr (FILL_ALPHA) {
+                v = _mm256_or_si256(v, alpha);
+            }
+
+            if constexpr (LANE_PIXELS * DBPP == 16) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * DBPP), v);
+            } else {
+                // The high lane store overwrites the unused tail bytes of the low lane
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * DBPP), _mm256_castsi256_si128(v));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + LANE_PIXELS) * DBPP),
+                                 _mm256_extracti128_si256(v, 1));
+            }
+        }
+        return i;
+    }
+
+    // Same lane layout as Avx2 with four lanes per shuffle. GCC 12 passes an uninitialized operand to the
+    // unmasked broadcast and extract builtins and warns about it; the zero-masked forms with a full mask
+    // compile to the same instructions.
+    REMOTE_DESK_TARGET_AVX512 static size_t Avx512(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+    {
+        static constexpr auto SHUFFLE = ShuffleMask();
+        static constexpr auto ALPHA = AlphaMask();
+        const __m512i shuffle =
+            _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i *>(SHUFFLE.data())));
+        const __m512i alpha =
+            _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i *>(ALPHA.data())));
+
+        const size_t src_bytes = pixel_count * SBPP;
+        const size_t dst_bytes = pixel_count * DBPP;
+        size_t i = 0;
+        for (; (i + 3 * LANE_PIXELS) * SBPP + 16 <= src_bytes && (i + 3 * LANE_PIXELS) * DBPP + 16 <= dst_bytes;
+             i += 4 * LANE_PIXELS) {
+            __m512i v;
+            if constexpr (LANE_PIXELS * SBPP == 16) {
+                v = _mm512_loadu_si512(src + i * SBPP);
+            } else {
+                v = _mm512_inserti32x4(_mm512_setzero_si512(),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * SBPP)), 0);
+                v = _mm512_inserti32x4(
+                    v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (i + LANE_PIXELS) * SBPP)), 1);
+                v = _mm512_inserti32x4(
+                    v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (i + 2 * LANE_PIXELS) * SBPP)), 2);
+                v = _mm512_inserti32x4(
+                    v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (i + 3 * LANE_PIXELS) * SBPP)), 3);
+            }
+
+            v = _mm512_shuffle_epi8(v, shuffle);
+            if constexpr (FILL_ALPHA) {
+                v = _mm512_or_si512(v, alpha);
+            }
+
+            if constexpr (LANE_PIXELS * DBPP == 16) {
+                _mm512_storeu_si512(dst + i * DBPP, v);
+            } else {
+                // Stored lane by lane in order, each store overwrites the unused tail of the previous one
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * DBPP),
+                                 _mm512_maskz_extracti32x4_epi32(0xF, v, 0));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + LANE_PIXELS) * DBPP),
+                                 _mm512_maskz_extracti32x4_epi32(0xF, v, 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + 2 * LANE_PIXELS) * DBPP),
+                                 _mm512_maskz_extracti32x4_epi32(0xF, v, 2));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (i + 3 * LANE_PIXELS) * DBPP),
+                                 _mm512_maskz_extracti32x4_epi32(0xF, v, 3));
+            }
+        }
+        return i;
+    }
+#endif
+
+    static void Run(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+    {
+        size_t done = 0;
+#ifdef REMOTE_DESK_X86_SIMD
+        switch (GetSimdLevel()) {
+            case SimdLevel::AVX512:
+                done = Avx512(src, dst, pixel_count);
+                break;
+            case SimdLevel::AVX2:
+                done = Avx2(src, dst, pixel_count);
+                break;
+            case SimdLevel::SSSE3:
+                done = Ssse3(src, dst, pixel_count);
+                break;
+            default:
+                break;
+        }
+#endif
+        Scalar(src, dst, done, pixel_count);
+    }
+};
+
+template <FrameFormat Src>
+bool DispatchPackedRgb(FrameFormat dst_format, const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    switch (dst_format) {
+        case FrameFormat::RGB24:
+            PackedRgbKernel<Src, FrameFormat::RGB24>::Run(src, dst, pixel_count);
+            return true;
+        case FrameFormat::BGR24:
+            PackedRgbKernel<Src, FrameFormat::BGR24>::Run(src, dst, pixel_count);
+            return true;
+        case FrameFormat::RGBA32:
+            PackedRgbKernel<Src, FrameFormat::RGBA32>::Run(src, dst, pixel_count);
+            return true;
+        case FrameFormat::BGRA32:
+            PackedRgbKernel<Src, FrameFormat::BGRA32>::Run(src, dst, pixel_count);
+            return true;
+        default:
+            return false;
+    }
+}
+
+//==============================================================================
+// Packed RGB -> I420 / NV12
+//==============================================================================
+
+// Converts the pixels of rect only, the rest of dst is left untouched
+template <FrameFormat Src, bool INTERLEAVED_CHROMA>
+void PackedRgbToYuv420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height, const FrameRect &rect)
+{
+    using S = PackedRgbTraits<Src>;
+
+    uint8_t *y_plane = dst;
+    uint8_t *u_plane = dst + (width * height);
+    uint8_t *v_plane = dst + (width * height) + (width * height / 4);
+
+    const uint32_t x_end = rect.x + rect.width;
+    const uint32_t y_end = rect.y + rect.height;
+    for (uint32_t y = rect.y; y < y_end; ++y) {
+        const uint8_t *row = src + static_cast<size_t>(y) * width * S::BYTES_PER_PIXEL;
+        uint8_t *y_row = y_plane + static_cast<size_t>(y) * width;
+        bool chroma_row = (y % 2 == 0);
+
+        for (uint32_t x = rect.x; x < x_end; ++x) {
+            const uint8_t *p = row + static_cast<size_t>(x) * S::BYTES_PER_PIXEL;
+            int r = p[S::RED];
+            int g = p[S::GREEN];
+            int b = p[S::BLUE];
+
+            // Coefficients are non-negative and sum to 256, Y never leaves 0..255
+            y_row[x] = static_cast<uint8_t>((77 * r + 150 * g + 29 * b) >> 8);
+
+            // Subsample U and V (4:2:0)
+            if (chroma_row && (x % 2 == 0)) {
+                int u = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
+                int v = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
+                if constexpr (INTERLEAVED_CHROMA) {
+                    size_t uv_idx = (y / 2) * width + x;
+                    u_plane[uv_idx] = static_cast<uint8_t>(std::clamp(u, 0, 255));
+                    u_plane[uv_idx + 1] = static_cast<uint8_t>(std::clamp(v, 0, 255));
+                } else {
+                    size_t uv_idx = (y / 2) * (width / 2) + (x / 2);
+                    u_plane[uv_idx] = static_cast<uint8_t>(std::clamp(u, 0, 255));
+                    v_plane[uv_idx] = static_cast<uint8_t>(std::clamp(v, 0, 255));
+                }
+            }
+        }
+    }
+}
+
+// Full chroma resolution, same coefficients as PackedRgbToYuv420 without subsampling
+template <FrameFormat Src>
+void PackedRgbToYuv444(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height, const FrameRect &rect)
+{
+    using S = PackedRgbTraits<Src>;
+
+    const size_t plane_size = static_cast<size_t>(width) * height;
+    uint8_t *y_plane = dst;
+    uint8_t *u_plane = dst + plane_size;
+    uint8_t *v_plane = dst + plane_size * 2;
+
+    const uint32_t x_end = rect.x + rect.width;
+    const uint32_t y_end = rect.y + rect.height;
+    for (uint32_t y = rect.y; y < y_end; ++y) {
+        const uint8_t *p = src + (static_cast<size_t>(y) * width + rect.x) * S::BYTES_PER_PIXEL;
+        size_t index = static_cast<size_t>(y) * width + rect.x;
+        for (uint32_t x = rect.x; x < x_end; ++x, ++index, p += S::BYTES_PER_PIXEL) {
+            int r = p[S::RED];
+            int g = p[S::GREEN];
+            int b = p[S::BLUE];
+
+            // U and V stay within -128..127 before the offset, no clamping needed
+            y_plane[index] = static_cast<uint8_t>((77 * r + 150 * g + 29 * b) >> 8);
+            u_plane[index] = static_cast<uint8_t>(((-43 * r - 85 * g + 128 * b) >> 8) + 128);
+            v_plane[index] = static_cast<uint8_t>(((128 * r - 107 * g - 21 * b) >> 8) + 128);
+        }
+    }
+}
+
+template <bool INTERLEAVED_CHROMA>
+bool DispatchPackedRgbToYuv420(FrameFormat src_format, const uint8_t *src, uint8_t *dst, uint32_t width,
+                               uint32_t height, const FrameRect &rect)
+{
+    switch (src_format) {
+        case FrameFormat::RGB24:
+            PackedRgbToYuv420<FrameFormat::RGB24, INTERLEAVED_CHROMA>(src, dst, width, height, rect);
+            return true;
+        case FrameFormat::BGR24:
+            PackedRgbToYuv420<FrameFormat::BGR24, INTERLEAVED_CHROMA>(src, dst, width, height, rect);
+            return true;
+        case FrameFormat::RGBA32:
+            PackedRgbToYuv420<FrameFormat::RGBA32, INTERLEAVED_CHROMA>(src, dst, width, height, rect);
+            return true;
+        case FrameFormat::BGRA32:
+            PackedRgbToYuv420<FrameFormat::BGRA32, INTERLEAVED_CHROMA>(src, dst, width, height, rect);
+            return true;
+        default:
+            return false;
+    }
+}
+
+//==============================================================================
+// X2RGB10 -> I010 / I420
+//==============================================================================
+
+// 10-bit samples with the 8-bit coefficients; I420 output keeps the top 8 bits of each result
+template <typename Sample, int SHIFT>
+void X2Rgb10ToYuv420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height, const FrameRect &rect)
+{
+    Sample *y_plane = reinterpret_cast<Sample *>(dst);
+    Sample *u_plane = y_plane + (width * height);
+    Sample *v_plane = u_plane + (width * height / 4);
+
+    const uint32_t x_end = rect.x + rect.width;
+    const uint32_t y_end = rect.y + rect.height;
+    for (uint32_t y = rect.y; y < y_end; ++y) {
+        const uint8_t *row = src + static_cast<size_t>(y) * width * 4;
+        Sample *y_row = y_plane + static_cast<size_t>(y) * width;
+        bool chroma_row = (y % 2 == 0);
+
+        for (uint32_t x = rect.x; x < x_end; ++x) {
+            uint32_t pixel;
+            std::memcpy(&pixel, row + static_cast<size_t>(x) * 4, sizeof(pixel));
+            int r = static_cast<int>((pixel >> 20) & 0x3FF);
+            int g = static_cast<int>((pixel >> 10) & 0x3FF);
+            int b = static_cast<int>(pixel & 0x3FF);
+
+            y_row[x] = static_cast<Sample>(((77 * r + 150 * g + 29 * b) >> 8) >> SHIFT);
+            if (chroma_row && (x % 2 == 0)) {
+                int u = ((-43 * r - 85 * g + 128 * b) >> 8) + 512;
+                int v = ((128 * r - 107 * g - 21 * b) >> 8) + 512;
+                size_t uv_idx = (y / 2) * (width / 2) + (x / 2);
+                u_plane[uv_idx] = static_cast<Sample>(std::clamp(u, 0, 1023) >> SHIFT);
+                v_plane[uv_idx] = static_cast<Sample>(std::clamp(v, 0, 1023) >> SHIFT);
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Depth-16 and depth-30 unpacking
+//==============================================================================
+
+inline void UnpackRgb565Scalar(const uint8_t *src, uint8_t *dst, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        uint32_t p = src[i * 2] | (src[i * 2 + 1] << 8);
+        uint32_t r = p >> 11;
+        uint32_t g = (p >> 5) & 0x3F;
+        uint32_t b = p & 0x1F;
+        dst[i * 4 + 0] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        dst[i * 4 + 1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        dst[i * 4 + 2] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+inline uint32_t SwapRedBlue10(uint32_t p)
+{
+    return (p & 0xC00FFC00u) | ((p & 0x3FFu) << 20) | ((p >> 20) & 0x3FFu);
+}
+
+#ifdef REMOTE_DESK_X86_SIMD
+// Widens each 5/6-bit channel to 8 bits, then interleaves 16-bit B|G and R|A pairs into BGRA
+REMOTE_DESK_TARGET_SSSE3 size_t UnpackRgb565Ssse3(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i alpha = _mm_set1_epi16(static_cast<short>(0xFF00));
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        __m128i r = _mm_srli_epi16(p, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(p, 5), mask6);
+        __m128i b = _mm_and_si128(p, mask5);
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+        __m128i ra = _mm_or_si128(r, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+    return i;
+}
+
+REMOTE_DESK_TARGET_AVX2 size_t UnpackRgb565Avx2(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i alpha = _mm256_set1_epi16(static_cast<short>(0xFF00));
+    size_t i = 0;
+    for (; i + 16 <= pixel_count; i += 16) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 2));
+        __m256i r = _mm256_srli_epi16(p, 11);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi16(p, 5), mask6);
+        __m256i b = _mm256_and_si256(p, mask5);
+        r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+        g = _mm256_or_si256(_mm256_slli_epi16(g, 2), _mm256_srli_epi16(g, 4));
+        b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+        __m256i bg = _mm256_or_si256(b, _mm256_slli_epi16(g, 8));
+        __m256i ra = _mm256_or_si256(r, alpha);
+
+        // Unpacking works per 128-bit lane: lo = pixels 0-3 | 8-11, hi = 4-7 | 12-15
+        __m256i lo = _mm256_unpacklo_epi16(bg, ra);
+        __m256i hi = _mm256_unpackhi_epi16(bg, ra);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    return i;
+}
+
+REMOTE_DESK_TARGET_SSSE3 size_t SwapRedBlue10Ssse3(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    const __m128i keep = _mm_set1_epi32(static_cast<int>(0xC00FFC00u));
+    const __m128i low = _mm_set1_epi32(0x3FF);
+    size_t i = 0;
+    for (; i + 4 <= pixel_count; i += 4) {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+        __m128i v = _mm_or_si128(_mm_and_si128(p, keep), _mm_slli_epi32(_mm_and_si128(p, low), 20));
+        v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(p, 20), low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), v);
+    }
+    return i;
+}
+
+REMOTE_DESK_TARGET_AVX2 size_t SwapRedBlue10Avx2(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    const __m256i keep = _mm256_set1_epi32(static_cast<int>(0xC00FFC00u));
+    const __m256i low = _mm256_set1_epi32(0x3FF);
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+        __m256i v = _mm256_or_si256(_mm256_and_si256(p, keep), _mm256_slli_epi32(_mm256_and_si256(p, low), 20));
+        v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi32(p, 20), low));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), v);
+    }
+    return i;
+}
+
+// The shifts use the zero-masked forms for the same GCC 12 warning as PackedRgbShuffle::Avx512()
+REMOTE_DESK_TARGET_AVX512 size_t SwapRedBlue10Avx512(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    const __m512i keep = _mm512_set1_epi32(static_cast<int>(0xC00FFC00u));
+    const __m512i low = _mm512_set1_epi32(0x3FF);
+    size_t i = 0;
+    for (; i + 16 <= pixel_count; i += 16) {
+        __m512i p = _mm512_loadu_si512(src + i * 4);
+        __m512i v = _mm512_or_si512(_mm512_and_si512(p, keep),
+                                    _mm512_maskz_slli_epi32(0xFFFF, _mm512_and_si512(p, low), 20));
+        v = _mm512_or_si512(v, _mm512_and_si512(_mm512_maskz_srli_epi32(0xFFFF, p, 20), low));
+        _mm512_storeu_si512(dst + i * 4, v);
+    }
+    return i;
+}
+#endif
+
+bool DispatchPackedRgbToYuv444(FrameFormat src_format, const uint8_t *src, uint8_t *dst, uint32_t width,
+                               uint32_t height, const FrameRect &rect)
+{
+    switch (src_format) {
+        case FrameFormat::RGB24:
+            PackedRgbToYuv444<FrameFormat::RGB24>(src, dst, width, height, rect);
+            return true;
+        case FrameFormat::BGR24:
+            PackedRgbToYuv444<FrameFormat::BGR24>(src, dst, width, height, rect);
+            return true;
+        case FrameFormat::RGBA32:
+            PackedRgbToYuv444<FrameFormat::RGBA32>(src, dst, width, height, rect);
+            return true;
+        case FrameFormat::BGRA32:
+            PackedRgbToYuv444<FrameFormat::BGRA32>(src, dst, width, height, rect);
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+bool IsPackedRgbFormat(FrameFormat format)
+{
+    switch (format) {
+        case FrameFormat::RGB24:
+        case FrameFormat::BGR24:
+        case FrameFormat::RGBA32:
+        case FrameFormat::BGRA32:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IsYuvOutputFormat(FrameFormat format)
+{
+    return format == FrameFormat::I420 || format == FrameFormat::NV12 || format == FrameFormat::I444 ||
+           format == FrameFormat::I010;
+}
+
+bool HasPackedRgbToYuvKernel(FrameFormat src_format, FrameFormat dst_format)
+{
+    if (src_format == FrameFormat::X2RGB10) {
+        return dst_format == FrameFormat::I010 || dst_format == FrameFormat::I420;
+    }
+    return IsPackedRgbFormat(src_format) &&
+           (dst_format == FrameFormat::I420 || dst_format == FrameFormat::NV12 || dst_format == FrameFormat::I444);
+}
+
+void UnpackRgb565ToBgra32(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    size_t done = 0;
+#ifdef REMOTE_DESK_X86_SIMD
+    switch (GetSimdLevel()) {
+        case SimdLevel::AVX512: // No 512-bit variant, the unpack is bound by its shuffles
+        case SimdLevel::AVX2:
+            done = UnpackRgb565Avx2(src, dst, pixel_count);
+            break;
+        case SimdLevel::SSSE3:
+            done = UnpackRgb565Ssse3(src, dst, pixel_count);
+            break;
+        default:
+            break;
+    }
+#endif
+    UnpackRgb565Scalar(src, dst, done, pixel_count);
+}
+
+void SwapX2Rgb10RedBlue(const uint8_t *src, uint8_t *dst, size_t pixel_count)
+{
+    size_t done = 0;
+#ifdef REMOTE_DESK_X86_SIMD
+    switch (GetSimdLevel()) {
+        case SimdLevel::AVX512:
+            done = SwapRedBlue10Avx512(src, dst, pixel_count);
+            break;
+        case SimdLevel::AVX2:
+            done = SwapRedBlue10Avx2(src, dst, pixel_count);
+            break;
+        case SimdLevel::SSSE3:
+            done = SwapRedBlue10Ssse3(src, dst, pixel_count);
+            break;
+        default:
+            break;
+    }
+#endif
+    for (size_t i = done; i < pixel_count; ++i) {
+        uint32_t p;
+        std::memcpy(&p, src + i * 4, sizeof(p));
+        p = SwapRedBlue10(p);
+        std::memcpy(dst + i * 4, &p, sizeof(p));
+    }
+}
+
+bool ConvertPackedRgb(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                      size_t pixel_count)
+{
+    if (!src || !dst) {
+        return false;
+    }
+
+    switch (src_format) {
+        case FrameFormat::RGB24:
+            return DispatchPackedRgb<FrameFormat::RGB24>(dst_format, src, dst, pixel_count);
+        case FrameFormat::BGR24:
+            return DispatchPackedRgb<FrameFormat::BGR24>(dst_format, src, dst, pixel_count);
+        case FrameFormat::RGBA32:
+            return DispatchPackedRgb<FrameFormat::RGBA32>(dst_format, src, dst, pixel_count);
+        case FrameFormat::BGRA32:
+            return DispatchPackedRgb<FrameFormat::BGRA32>(dst_format, src, dst, pixel_count);
+        default:
+            return false;
+    }
+}
+
+bool ConvertPackedRgbToYuv(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                           uint32_t width, uint32_t height)
+{
+    FrameRect rect;
+    rect.width = static_cast<uint16_t>(width);
+    rect.height = static_cast<uint16_t>(height);
+    return ConvertPackedRgbToYuvRect(src_format, dst_format, src, dst, width, height, rect);
+}
+
+bool ConvertPackedRgbToYuvRect(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                               uint32_t width, uint32_t height, const FrameRect &rect)
+{
+    if (!src || !dst || rect.x + rect.width > width || rect.y + rect.height > height) {
+        return false;
+    }
+
+    if (src_format == FrameFormat::X2RGB10) {
+        switch (dst_format) {
+            case FrameFormat::I010:
+                X2Rgb10ToYuv420<uint16_t, 0>(src, dst, width, height, rect);
+                return true;
+            case FrameFormat::I420:
+                X2Rgb10ToYuv420<uint8_t, 2>(src, dst, width, height, rect);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    switch (dst_format) {
+        case FrameFormat::I420:
+            return DispatchPackedRgbToYuv420<false>(src_format, src, dst, width, height, rect);
+        case FrameFormat::NV12:
+            return DispatchPackedRgbToYuv420<true>(src_format, src, dst, width, height, rect);
+        case FrameFormat::I444:
+            return DispatchPackedRgbToYuv444(src_format, src, dst, width, height, rect);
+        default:
+            return false;
+    }
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,103 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_PACKED_RGB_KERNELS_H
+#define LMSHAO_REMOTE_DESK_PACKED_RGB_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../core/frame.h"
+#include "simd_support.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Byte layout of a packed RGB format
+ * Offsets of each channel inside one pixel, ALPHA is -1 for 24-bit formats.
+ * Kernels are generated from these traits, adding a packed format only needs
+ * a new specialization and a case in the dispatch switch.
+ */
+template <FrameFormat F>
+struct PackedRgbTraits;
+
+template <>
+struct PackedRgbTraits<FrameFormat::RGB24> {
+    static constexpr int BYTES_PER_PIXEL = 3;
+    static constexpr int RED = 0, GREEN = 1, BLUE = 2, ALPHA = -1;
+};
+
+template <>
+struct PackedRgbTraits<FrameFormat::BGR24> {
+    static constexpr int BYTES_PER_PIXEL = 3;
+    static constexpr int RED = 2, GREEN = 1, BLUE = 0, ALPHA = -1;
+};
+
+template <>
+struct PackedRgbTraits<FrameFormat::RGBA32> {
+    static constexpr int BYTES_PER_PIXEL = 4;
+    static constexpr int RED = 0, GREEN = 1, BLUE = 2, ALPHA = 3;
+};
+
+template <>
+struct PackedRgbTraits<FrameFormat::BGRA32> {
+    static constexpr int BYTES_PER_PIXEL = 4;
+    static constexpr int RED = 2, GREEN = 1, BLUE = 0, ALPHA = 3;
+};
+
+bool IsPackedRgbFormat(FrameFormat format);
+
+/**
+ * @brief Convert tightly packed pixels between two packed RGB formats
+ * Alpha is copied when both formats carry it and set to 255 when only the destination does.
+ * @return false if either format is not a packed RGB format
+ */
+bool ConvertPackedRgb(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                      size_t pixel_count);
+
+/**
+ * @brief Whether ConvertPackedRgbToYuv() can produce this format (I420, NV12, I444 or I010)
+ */
+bool IsYuvOutputFormat(FrameFormat format);
+
+/**
+ * @brief Whether ConvertPackedRgbToYuv() has a kernel for this format pair
+ */
+bool HasPackedRgbToYuvKernel(FrameFormat src_format, FrameFormat dst_format);
+
+/**
+ * @brief Convert a tightly packed RGB image to I420, NV12 or I444, or an X2RGB10 image to I010 or I420
+ * BT.601 full-range coefficients, 4:2:0 formats take the top-left chroma sample.
+ */
+bool ConvertPackedRgbToYuv(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                           uint32_t width, uint32_t height);
+
+/**
+ * @brief Convert one rectangle of a tightly packed RGB image into an existing I420, NV12 or I444 image
+ * Pixels outside the rectangle keep their value. For 4:2:0 the rectangle should start and end
+ * on even coordinates, otherwise its chroma is taken from the samples it happens to cover.
+ * @return false for unsupported formats or a rectangle outside the image
+ */
+bool ConvertPackedRgbToYuvRect(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                               uint32_t width, uint32_t height, const FrameRect &rect);
+
+/**
+ * @brief Unpack little-endian RGB565 pixels (depth-16 visuals) to BGRA32
+ * The high bits of each channel are replicated into the low ones, so 0x1F becomes 0xFF.
+ */
+void UnpackRgb565ToBgra32(const uint8_t *src, uint8_t *dst, size_t pixel_count);
+
+/**
+ * @brief Swap the 10-bit red and blue fields of packed 30-bit pixels (X2BGR10 <-> X2RGB10)
+ * src and dst may be the same buffer.
+ */
+void SwapX2Rgb10RedBlue(const uint8_t *src, uint8_t *dst, size_t pixel_count);
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_PACKED_RGB_KERNELS_H
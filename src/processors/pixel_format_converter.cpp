@@ -10,9 +10,38 @@
 
 #include <algorithm>
 #include <cstring>
+#include <vector>
+
+#include "kernel_autotuner.h"
+#include "packed_rgb_kernels.h"
 
 namespace lmshao::remotedesk {
 
+namespace {
+
+// Smaller bands cost more in handing them to the workers than they save
+constexpr uint32_t MIN_BAND_ROWS = 64;
+
+// Grow a rectangle to whole 2x2 chroma blocks, clipped to the frame
+FrameRect AlignToChromaBlock(const FrameRect &rect, uint32_t width, uint32_t height)
+{
+    uint32_t left = rect.x & ~1u;
+    uint32_t top = rect.y & ~1u;
+    uint32_t right = std::min<uint32_t>((rect.x + rect.width + 1u) & ~1u, width);
+    uint32_t bottom = std::min<uint32_t>((rect.y + rect.height + 1u) & ~1u, height);
+
+    FrameRect aligned;
+    if (left < right && top < bottom) {
+        aligned.x = static_cast<uint16_t>(left);
+        aligned.y = static_cast<uint16_t>(top);
+        aligned.width = static_cast<uint16_t>(right - left);
+        aligned.height = static_cast<uint16_t>(bottom - top);
+    }
+    return aligned;
+}
+
+} // namespace
+
 PixelFormatConverter::PixelFormatConverter(const PixelFormatConverterConfig &config) : config_(config) {}
 
 PixelFormatConverter::~PixelFormatConverter()
@@ -45,35 +74,52 @@ bool PixelFormatConverter::Initialize()
     return true;
 }
 
-void PixelFormatConverter::OnFrame(std::shared_ptr<Frame> frame)
+void PixelFormatConverter::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    auto output_frame = Process(frame);
+    if (output_frame) {
+        DeliverFrame(output_frame);
+    }
+}
+
+std::shared_ptr<Frame> PixelFormatConverter::Process(const std::shared_ptr<Frame> &frame)
 {
     if (!frame || !frame->IsValid() || !frame->IsVideo()) {
-        return;
+        return nullptr;
     }
 
     // Check if conversion is needed
     if (frame->format == config_.output_format) {
-        // No conversion needed, forward frame directly
-        DeliverFrame(frame);
-        return;
+        // No conversion needed, forward frame directly. The canvas misses this frame's changes.
+        canvas_.reset();
+        return frame;
     }
 
     // Convert frame
-    auto converted_frame = ConvertFrame(frame);
-    if (converted_frame) {
-        DeliverFrame(converted_frame);
-    }
+    return ConvertFrame(frame);
 }
 
-std::shared_ptr<Frame> PixelFormatConverter::ConvertFrame(std::shared_ptr<Frame> input_frame)
+std::shared_ptr<Frame> PixelFormatConverter::ConvertFrame(const std::shared_ptr<Frame> &input_frame)
 {
     if (!input_frame || !input_frame->IsValid()) {
         return nullptr;
     }
 
+    // Kernels read whole planes, a short buffer must not be read past its end
+    size_t input_size = CalculateOutputFrameSize(input_frame->width(), input_frame->height(), input_frame->format);
+    if (input_frame->Size() < input_size) {
+        canvas_.reset();
+        return nullptr;
+    }
+
     // Calculate output frame size
     size_t output_size = CalculateOutputFrameSize(input_frame->width(), input_frame->height(), config_.output_format);
 
+    bool rgb_input = IsPackedRgbFormat(input_frame->format) || input_frame->format == FrameFormat::X2RGB10;
+    if (config_.incremental && rgb_input && IsYuvOutputFormat(config_.output_format)) {
+        return ConvertIncremental(input_frame, output_size);
+    }
+
     // Create output frame with correct size
     auto output_frame = std::make_shared<Frame>(output_size);
     output_frame->format = config_.output_format;
@@ -86,394 +132,128 @@ std::shared_ptr<Frame> PixelFormatConverter::ConvertFrame(std::shared_ptr<Frame>
     // Set frame size
     output_frame->SetSize(output_size);
 
-    // Perform format conversion
+    // Perform format conversion with the kernels generated for this format pair
     bool success = false;
-    switch (input_frame->format) {
-        case FrameFormat::BGRA32:
-            success = ConvertFromBGRA32(input_frame, output_frame);
-            break;
-        case FrameFormat::RGBA32:
-            success = ConvertFromRGBA32(input_frame, output_frame);
-            break;
-        case FrameFormat::RGB24:
-            success = ConvertFromRGB24(input_frame, output_frame);
-            break;
-        case FrameFormat::BGR24:
-            success = ConvertFromBGR24(input_frame, output_frame);
-            break;
-        default:
-            return nullptr; // Unsupported input format
-    }
-
-    return success ? output_frame : nullptr;
-}
-
-bool PixelFormatConverter::ConvertFromBGRA32(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output)
-{
-    const uint8_t *src = input->data();
-    uint8_t *dst = output->data();
-    uint32_t width = input->width();
-    uint32_t height = input->height();
-
-    switch (config_.output_format) {
-        case FrameFormat::RGBA32:
-            return ConvertBGRA32ToRGBA32(src, dst, width, height);
-        case FrameFormat::RGB24:
-            return ConvertBGRA32ToRGB24(src, dst, width, height);
-        case FrameFormat::BGR24:
-            return ConvertBGRA32ToBGR24(src, dst, width, height);
-        case FrameFormat::I420:
-            return ConvertBGRA32ToI420(src, dst, width, height);
-        default:
-            return false;
-    }
-}
-
-bool PixelFormatConverter::ConvertFromRGBA32(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output)
-{
-    const uint8_t *src = input->data();
-    uint8_t *dst = output->data();
-    uint32_t width = input->width();
-    uint32_t height = input->height();
-
-    switch (config_.output_format) {
-        case FrameFormat::BGRA32:
-            return ConvertRGBA32ToBGRA32(src, dst, width, height);
-        case FrameFormat::RGB24:
-            return ConvertRGBA32ToRGB24(src, dst, width, height);
-        case FrameFormat::BGR24:
-            return ConvertRGBA32ToBGR24(src, dst, width, height);
-        case FrameFormat::I420:
-            return ConvertRGBA32ToI420(src, dst, width, height);
-        default:
-            return false;
-    }
-}
-
-bool PixelFormatConverter::ConvertFromRGB24(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output)
-{
-    const uint8_t *src = input->data();
-    uint8_t *dst = output->data();
-    uint32_t width = input->width();
-    uint32_t height = input->height();
-
-    switch (config_.output_format) {
-        case FrameFormat::BGR24:
-            return ConvertRGB24ToBGR24(src, dst, width, height);
-        case FrameFormat::RGBA32:
-            return ConvertRGB24ToRGBA32(src, dst, width, height);
-        case FrameFormat::BGRA32:
-            return ConvertRGB24ToBGRA32(src, dst, width, height);
-        case FrameFormat::I420:
-            return ConvertRGB24ToI420(src, dst, width, height);
-        default:
-            return false;
-    }
-}
-
-bool PixelFormatConverter::ConvertFromBGR24(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output)
-{
-    const uint8_t *src = input->data();
-    uint8_t *dst = output->data();
-    uint32_t width = input->width();
-    uint32_t height = input->height();
-
-    switch (config_.output_format) {
-        case FrameFormat::RGB24:
-            return ConvertBGR24ToRGB24(src, dst, width, height);
-        case FrameFormat::RGBA32:
-            return ConvertBGR24ToRGBA32(src, dst, width, height);
-        case FrameFormat::BGRA32:
-            return ConvertBGR24ToBGRA32(src, dst, width, height);
-        case FrameFormat::I420:
-            return ConvertBGR24ToI420(src, dst, width, height);
-        default:
-            return false;
+    if (IsYuv420Format(input_frame->format)) {
+        success = ConvertYuv420ToPackedRgb(input_frame->format, config_.output_format, input_frame->data(),
+                                           output_frame->data(), input_frame->width(), input_frame->height(),
+                                           config_.yuv_options);
+    } else if (IsYuvOutputFormat(config_.output_format)) {
+        success = ConvertToYuv(input_frame, output_frame->data());
+    } else {
+        size_t pixel_count = static_cast<size_t>(input_frame->width()) * input_frame->height();
+        success = ConvertPackedRgb(input_frame->format, config_.output_format, input_frame->data(),
+                                   output_frame->data(), pixel_count);
     }
-}
-
-// Simple format conversions - RGB/BGR channel swapping
-bool PixelFormatConverter::ConvertBGRA32ToRGBA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        // BGRA -> RGBA: swap B and R channels
-        dst[i * 4 + 0] = src[i * 4 + 2]; // R = B
-        dst[i * 4 + 1] = src[i * 4 + 1]; // G = G
-        dst[i * 4 + 2] = src[i * 4 + 0]; // B = R
-        dst[i * 4 + 3] = src[i * 4 + 3]; // A = A
-    }
-    return true;
-}
-
-bool PixelFormatConverter::ConvertRGBA32ToBGRA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        // RGBA -> BGRA: swap R and B channels
-        dst[i * 4 + 0] = src[i * 4 + 2]; // B = B
-        dst[i * 4 + 1] = src[i * 4 + 1]; // G = G
-        dst[i * 4 + 2] = src[i * 4 + 0]; // R = R
-        dst[i * 4 + 3] = src[i * 4 + 3]; // A = A
-    }
-    return true;
-}
 
-bool PixelFormatConverter::ConvertRGB24ToBGR24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        // RGB -> BGR: swap R and B channels
-        dst[i * 3 + 0] = src[i * 3 + 2]; // B = R
-        dst[i * 3 + 1] = src[i * 3 + 1]; // G = G
-        dst[i * 3 + 2] = src[i * 3 + 0]; // R = B
-    }
-    return true;
-}
-
-bool PixelFormatConverter::ConvertBGR24ToRGB24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    return ConvertRGB24ToBGR24(src, dst, width, height); // Same operation
-}
-
-// 24-bit to 32-bit conversions (add alpha channel)
-bool PixelFormatConverter::ConvertRGB24ToRGBA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 4 + 0] = src[i * 3 + 0]; // R
-        dst[i * 4 + 1] = src[i * 3 + 1]; // G
-        dst[i * 4 + 2] = src[i * 3 + 2]; // B
-        dst[i * 4 + 3] = 255;            // A = fully opaque
-    }
-    return true;
-}
-
-bool PixelFormatConverter::ConvertRGB24ToBGRA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 4 + 0] = src[i * 3 + 2]; // B = R
-        dst[i * 4 + 1] = src[i * 3 + 1]; // G = G
-        dst[i * 4 + 2] = src[i * 3 + 0]; // R = B
-        dst[i * 4 + 3] = 255;            // A = fully opaque
-    }
-    return true;
-}
-
-// 32-bit to 24-bit conversions (remove alpha channel)
-bool PixelFormatConverter::ConvertBGRA32ToRGB24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 3 + 0] = src[i * 4 + 2]; // R = B
-        dst[i * 3 + 1] = src[i * 4 + 1]; // G = G
-        dst[i * 3 + 2] = src[i * 4 + 0]; // B = R
+    if (!success) {
+        return nullptr;
     }
-    return true;
-}
 
-bool PixelFormatConverter::ConvertBGRA32ToBGR24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 3 + 0] = src[i * 4 + 0]; // B = B
-        dst[i * 3 + 1] = src[i * 4 + 1]; // G = G
-        dst[i * 3 + 2] = src[i * 4 + 2]; // R = R
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_converted++;
+        stats_.pixels_converted += static_cast<uint64_t>(input_frame->width()) * input_frame->height();
     }
-    return true;
+    return output_frame;
 }
 
-// RGB to I420 conversions (simplified, for complex YUV you might want FFmpeg)
-bool PixelFormatConverter::ConvertBGRA32ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
+std::shared_ptr<Frame> PixelFormatConverter::ConvertIncremental(const std::shared_ptr<Frame> &input_frame,
+                                                                size_t output_size)
 {
-    // Simplified RGB to YUV conversion using ITU-R BT.601 coefficients
-    uint8_t *y_plane = dst;
-    uint8_t *u_plane = dst + (width * height);
-    uint8_t *v_plane = dst + (width * height) + (width * height / 4);
-
-    for (uint32_t y = 0; y < height; ++y) {
-        for (uint32_t x = 0; x < width; ++x) {
-            size_t src_idx = (y * width + x) * 4;
-            uint8_t b = src[src_idx + 0];
-            uint8_t g = src[src_idx + 1];
-            uint8_t r = src[src_idx + 2];
-
-            // Convert to YUV using standard coefficients
-            int Y = (77 * r + 150 * g + 29 * b) >> 8;
-            int U = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
-            int V = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
-
-            // Clamp values
-            Y = std::clamp(Y, 0, 255);
-            U = std::clamp(U, 0, 255);
-            V = std::clamp(V, 0, 255);
-
-            y_plane[y * width + x] = static_cast<uint8_t>(Y);
-
-            // Subsample U and V (4:2:0)
-            if ((y % 2 == 0) && (x % 2 == 0)) {
-                size_t uv_idx = (y / 2) * (width / 2) + (x / 2);
-                u_plane[uv_idx] = static_cast<uint8_t>(U);
-                v_plane[uv_idx] = static_cast<uint8_t>(V);
+    const uint32_t width = input_frame->width();
+    const uint32_t height = input_frame->height();
+
+    // Rectangles describe the change from the previous frame, which the canvas must hold
+    bool incremental = !input_frame->dirty_rects.empty() && canvas_ && canvas_->format == config_.output_format &&
+                       canvas_->width() == width && canvas_->height() == height;
+
+    auto canvas = AcquireCanvas(canvas_, output_size, incremental);
+    bool copied = incremental && canvas != canvas_; // Still held downstream
+    canvas->dirty_rects.clear();
+
+    bool success = true;
+    uint64_t pixels = 0;
+    if (incremental) {
+        for (const auto &dirty : input_frame->dirty_rects) {
+            FrameRect rect = AlignToChromaBlock(dirty, width, height);
+            if (rect.IsEmpty()) {
+                continue;
             }
+            success = ConvertPackedRgbToYuvRect(input_frame->format, config_.output_format, input_frame->data(),
+                                                canvas->data(), width, height, rect) &&
+                      success;
+            canvas->dirty_rects.push_back(rect);
+            pixels += static_cast<uint64_t>(rect.width) * rect.height;
         }
+    } else {
+        success = ConvertToYuv(input_frame, canvas->data());
+        pixels = static_cast<uint64_t>(width) * height;
     }
 
-    return true;
-}
-
-// Other format conversion implementations follow similar patterns...
-bool PixelFormatConverter::ConvertRGBA32ToRGB24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 3 + 0] = src[i * 4 + 0]; // R = R
-        dst[i * 3 + 1] = src[i * 4 + 1]; // G = G
-        dst[i * 3 + 2] = src[i * 4 + 2]; // B = B
+    if (!success) {
+        canvas_.reset();
+        return nullptr;
     }
-    return true;
-}
 
-bool PixelFormatConverter::ConvertRGBA32ToBGR24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 3 + 0] = src[i * 4 + 2]; // B = B
-        dst[i * 3 + 1] = src[i * 4 + 1]; // G = G
-        dst[i * 3 + 2] = src[i * 4 + 0]; // R = R
+    canvas->format = config_.output_format;
+    canvas->timestamp = input_frame->timestamp;
+    canvas->width() = input_frame->width();
+    canvas->height() = input_frame->height();
+    canvas->video_info.framerate = input_frame->video_info.framerate;
+    canvas->video_info.is_keyframe = input_frame->video_info.is_keyframe;
+    canvas_ = canvas;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_converted++;
+        stats_.frames_incremental += incremental ? 1 : 0;
+        stats_.canvas_copies += copied ? 1 : 0;
+        stats_.pixels_converted += pixels;
     }
-    return true;
+    return canvas;
 }
 
-bool PixelFormatConverter::ConvertRGBA32ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
+bool PixelFormatConverter::ConvertToYuv(const std::shared_ptr<Frame> &input_frame, uint8_t *dst)
 {
-    // Similar to BGRA32ToI420 but with different channel order
-    uint8_t *y_plane = dst;
-    uint8_t *u_plane = dst + (width * height);
-    uint8_t *v_plane = dst + (width * height) + (width * height / 4);
-
-    for (uint32_t y = 0; y < height; ++y) {
-        for (uint32_t x = 0; x < width; ++x) {
-            size_t src_idx = (y * width + x) * 4;
-            uint8_t r = src[src_idx + 0];
-            uint8_t g = src[src_idx + 1];
-            uint8_t b = src[src_idx + 2];
-
-            // Convert to YUV
-            int Y = (77 * r + 150 * g + 29 * b) >> 8;
-            int U = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
-            int V = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
-
-            Y = std::clamp(Y, 0, 255);
-            U = std::clamp(U, 0, 255);
-            V = std::clamp(V, 0, 255);
-
-            y_plane[y * width + x] = static_cast<uint8_t>(Y);
-
-            if ((y % 2 == 0) && (x % 2 == 0)) {
-                size_t uv_idx = (y / 2) * (width / 2) + (x / 2);
-                u_plane[uv_idx] = static_cast<uint8_t>(U);
-                v_plane[uv_idx] = static_cast<uint8_t>(V);
-            }
-        }
+    const uint32_t width = input_frame->width();
+    const uint32_t height = input_frame->height();
+    uint32_t threads = config_.thread_count > 0 ? config_.thread_count : GetTunedConverterThreads(width, height);
+    threads = std::min(threads, std::max(1u, height / MIN_BAND_ROWS));
+    if (threads <= 1) {
+        return ConvertPackedRgbToYuv(input_frame->format, config_.output_format, input_frame->data(), dst, width,
+                                     height);
     }
 
-    return true;
-}
-
-bool PixelFormatConverter::ConvertBGR24ToRGBA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 4 + 0] = src[i * 3 + 2]; // R = R
-        dst[i * 4 + 1] = src[i * 3 + 1]; // G = G
-        dst[i * 4 + 2] = src[i * 3 + 0]; // B = B
-        dst[i * 4 + 3] = 255;            // A = fully opaque
+    // Bands start on even rows so that no 4:2:0 chroma row is shared between two threads
+    const uint32_t band_rows = ((height + threads - 1) / threads + 1) & ~1u;
+    std::vector<FrameRect> bands;
+    for (uint32_t top = 0; top < height; top += band_rows) {
+        FrameRect band;
+        band.y = static_cast<uint16_t>(top);
+        band.width = static_cast<uint16_t>(width);
+        band.height = static_cast<uint16_t>(std::min(band_rows, height - top));
+        bands.push_back(band);
     }
-    return true;
-}
 
-bool PixelFormatConverter::ConvertBGR24ToBGRA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    size_t pixel_count = width * height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        dst[i * 4 + 0] = src[i * 3 + 0]; // B = B
-        dst[i * 4 + 1] = src[i * 3 + 1]; // G = G
-        dst[i * 4 + 2] = src[i * 3 + 2]; // R = R
-        dst[i * 4 + 3] = 255;            // A = fully opaque
-    }
-    return true;
-}
+    std::vector<char> results(bands.size(), 0);
+    auto convert_band = [&](size_t index) {
+        results[index] = ConvertPackedRgbToYuvRect(input_frame->format, config_.output_format, input_frame->data(),
+                                                   dst, width, height, bands[index]);
+    };
 
-bool PixelFormatConverter::ConvertRGB24ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
-{
-    uint8_t *y_plane = dst;
-    uint8_t *u_plane = dst + (width * height);
-    uint8_t *v_plane = dst + (width * height) + (width * height / 4);
-
-    for (uint32_t y = 0; y < height; ++y) {
-        for (uint32_t x = 0; x < width; ++x) {
-            size_t src_idx = (y * width + x) * 3;
-            uint8_t r = src[src_idx + 0];
-            uint8_t g = src[src_idx + 1];
-            uint8_t b = src[src_idx + 2];
-
-            // Convert to YUV
-            int Y = (77 * r + 150 * g + 29 * b) >> 8;
-            int U = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
-            int V = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
-
-            Y = std::clamp(Y, 0, 255);
-            U = std::clamp(U, 0, 255);
-            V = std::clamp(V, 0, 255);
-
-            y_plane[y * width + x] = static_cast<uint8_t>(Y);
-
-            if ((y % 2 == 0) && (x % 2 == 0)) {
-                size_t uv_idx = (y / 2) * (width / 2) + (x / 2);
-                u_plane[uv_idx] = static_cast<uint8_t>(U);
-                v_plane[uv_idx] = static_cast<uint8_t>(V);
-            }
-        }
+    // The calling thread converts bands too, so one band fewer than the count needs a worker
+    if (!band_workers_ || band_workers_->GetThreadCount() + 1 < bands.size()) {
+        band_workers_ = std::make_unique<BandWorkerPool>(bands.size() - 1);
     }
-
-    return true;
+    band_workers_->Run(bands.size(), convert_band);
+    return std::all_of(results.begin(), results.end(), [](char ok) { return ok != 0; });
 }
 
-bool PixelFormatConverter::ConvertBGR24ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height)
+PixelFormatConverter::ConversionStats PixelFormatConverter::GetStats() const
 {
-    uint8_t *y_plane = dst;
-    uint8_t *u_plane = dst + (width * height);
-    uint8_t *v_plane = dst + (width * height) + (width * height / 4);
-
-    for (uint32_t y = 0; y < height; ++y) {
-        for (uint32_t x = 0; x < width; ++x) {
-            size_t src_idx = (y * width + x) * 3;
-            uint8_t b = src[src_idx + 0];
-            uint8_t g = src[src_idx + 1];
-            uint8_t r = src[src_idx + 2];
-
-            // Convert to YUV
-            int Y = (77 * r + 150 * g + 29 * b) >> 8;
-            int U = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
-            int V = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
-
-            Y = std::clamp(Y, 0, 255);
-            U = std::clamp(U, 0, 255);
-            V = std::clamp(V, 0, 255);
-
-            y_plane[y * width + x] = static_cast<uint8_t>(Y);
-
-            if ((y % 2 == 0) && (x % 2 == 0)) {
-                size_t uv_idx = (y / 2) * (width / 2) + (x / 2);
-                u_plane[uv_idx] = static_cast<uint8_t>(U);
-                v_plane[uv_idx] = static_cast<uint8_t>(V);
-            }
-        }
-    }
-
-    return true;
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
 }
 
 size_t PixelFormatConverter::CalculateOutputFrameSize(uint32_t width, uint32_t height, FrameFormat format)
@@ -485,12 +265,22 @@ size_t PixelFormatConverter::CalculateOutputFrameSize(uint32_t width, uint32_t h
 
         case FrameFormat::RGBA32:
         case FrameFormat::BGRA32:
+        case FrameFormat::X2RGB10:
             return width * height * 4;
 
         case FrameFormat::I420:
+        case FrameFormat::NV12:
             // Y plane + U plane (1/4) + V plane (1/4) = 1.5 * width * height
             return width * height + (width * height / 2);
 
+        case FrameFormat::I444:
+            // Y, U and V planes at full resolution
+            return width * height * 3;
+
+        case FrameFormat::I010:
+            // I420 layout with two bytes per sample
+            return (width * height + (width * height / 2)) * 2;
+
         default:
             return 0;
     }
@@ -504,6 +294,10 @@ bool PixelFormatConverter::IsFormatSupported(FrameFormat format)
         case FrameFormat::RGBA32:
         case FrameFormat::BGRA32:
         case FrameFormat::I420:
+        case FrameFormat::NV12:
+        case FrameFormat::I444:    // Output only, from packed RGB
+        case FrameFormat::X2RGB10: // Input only, to I010 or I420
+        case FrameFormat::I010:    // Output only, from X2RGB10
             return true;
         default:
             return false;
@@ -10,9 +10,12 @@
 #define LMSHAO_REMOTE_DESK_PIXEL_FORMAT_CONVERTER_H
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 
+#include "../core/band_worker_pool.h"
 #include "../core/media_processor.h"
+#include "yuv_rgb_kernels.h"
 
 namespace lmshao::remotedesk {
 
@@ -23,6 +26,14 @@ struct PixelFormatConverterConfig {
     FrameFormat input_format = FrameFormat::BGRA32;
     FrameFormat output_format = FrameFormat::I420;
     bool enable_threading = true;
+    YuvToRgbOptions yuv_options; // Matrix, range and chroma upsampling for I420/NV12 input
+
+    // RGB -> YUV keeps the output as a persistent canvas and converts only the frame's dirty_rects
+    bool incremental = true;
+
+    // Row bands a whole-frame RGB -> YUV conversion is split into, run on threads owned by the converter
+    // (0 = the count KernelAutotuner measured for the frame size, 1 = processing thread only)
+    uint32_t thread_count = 0;
 };
 
 /**
@@ -41,61 +52,64 @@ public:
 
     // MediaProcessor interface implementation
     bool Initialize() override;
-    void OnFrame(std::shared_ptr<Frame> frame) override;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+    void OnFramesDropped() override { canvas_.reset(); } // Next frame is converted whole
+
+    /**
+     * @brief Convert one frame without delivering it (used by StaticPipeline)
+     * @return The converted frame, the input itself if no conversion is needed, or nullptr
+     */
+    std::shared_ptr<Frame> Process(const std::shared_ptr<Frame> &frame);
+
+    struct ConversionStats {
+        uint64_t frames_converted = 0;
+        uint64_t frames_incremental = 0; // Converted from dirty rectangles only
+        uint64_t pixels_converted = 0;
+        uint64_t canvas_copies = 0; // Canvas still held downstream, copied before the update
+    };
+    ConversionStats GetStats() const;
 
 private:
     /**
      * @brief Convert pixel format using software conversion
      */
-    std::shared_ptr<Frame> ConvertFrame(std::shared_ptr<Frame> input_frame);
+    std::shared_ptr<Frame> ConvertFrame(const std::shared_ptr<Frame> &input_frame);
 
     /**
-     * @brief Calculate output frame size
+     * @brief Convert the dirty rectangles of an RGB frame into the persistent YUV canvas
+     * Falls back to a whole-frame conversion when the frame carries no rectangles or
+     * the canvas does not match its size and format.
      */
-    size_t CalculateOutputFrameSize(uint32_t width, uint32_t height, FrameFormat format);
+    std::shared_ptr<Frame> ConvertIncremental(const std::shared_ptr<Frame> &input_frame, size_t output_size);
 
     /**
-     * @brief Check if format is supported by software converter
+     * @brief Convert a whole RGB frame to the YUV output format, in parallel row bands if configured
      */
-    bool IsFormatSupported(FrameFormat format);
+    bool ConvertToYuv(const std::shared_ptr<Frame> &input_frame, uint8_t *dst);
 
     /**
-     * @brief Format-specific conversion methods
+     * @brief Calculate output frame size
      */
-    bool ConvertFromBGRA32(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output);
-    bool ConvertFromRGBA32(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output);
-    bool ConvertFromRGB24(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output);
-    bool ConvertFromBGR24(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output);
+    size_t CalculateOutputFrameSize(uint32_t width, uint32_t height, FrameFormat format);
 
     /**
-     * @brief Low-level conversion functions
+     * @brief Check if format is supported by software converter
      */
-    bool ConvertBGRA32ToRGBA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGBA32ToBGRA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGB24ToBGR24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertBGR24ToRGB24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-
-    // 24-bit to 32-bit conversions
-    bool ConvertRGB24ToRGBA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGB24ToBGRA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertBGR24ToRGBA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertBGR24ToBGRA32(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-
-    // 32-bit to 24-bit conversions
-    bool ConvertBGRA32ToRGB24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertBGRA32ToBGR24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGBA32ToRGB24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGBA32ToBGR24(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-
-    // RGB to YUV conversions (simplified)
-    bool ConvertBGRA32ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGBA32ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertRGB24ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
-    bool ConvertBGR24ToI420(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height);
+    bool IsFormatSupported(FrameFormat format);
 
 private:
     PixelFormatConverterConfig config_;
     mutable std::mutex mutex_;
+
+    // Last published YUV output, only touched by the processing thread
+    std::shared_ptr<Frame> canvas_;
+
+    // Threads running the bands of ConvertToYuv(), grown to the largest band count seen
+    std::unique_ptr<BandWorkerPool> band_workers_;
+
+    // Statistics
+    mutable std::mutex stats_mutex_;
+    ConversionStats stats_;
 };
 
 } // namespace lmshao::remotedesk
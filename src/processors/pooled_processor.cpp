@@ -0,0 +1,93 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "pooled_processor.h"
+
+#include <typeinfo>
+
+#include "../core/frame_tracer.h"
+#include "../core/type_name.h"
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+PooledProcessor::PooledProcessor(std::shared_ptr<MediaProcessor> inner, std::shared_ptr<SessionWorkerPool> pool,
+                                 const std::string &session_id)
+    : inner_(std::move(inner)), pool_(std::move(pool)), session_id_(session_id), relay_(std::make_shared<Relay>(this))
+{
+}
+
+PooledProcessor::~PooledProcessor()
+{
+    Cleanup();
+}
+
+bool PooledProcessor::Initialize()
+{
+    if (!inner_ || !pool_) {
+        LOG_ERROR("PooledProcessor needs a processor and a worker pool");
+        return false;
+    }
+
+    inner_->AddSink(relay_);
+    heartbeat_ = StageWatchdog::GetInstance()->RegisterStage(GetTypeName(typeid(*inner_).name()), session_id_,
+                                                             StageKind::WORK);
+    return inner_->Initialize();
+}
+
+void PooledProcessor::Cleanup()
+{
+    if (inner_) {
+        inner_->RemoveSink(relay_);
+        inner_->Cleanup();
+    }
+    heartbeat_.reset();
+}
+
+void PooledProcessor::Stop()
+{
+    if (inner_) {
+        inner_->Stop();
+    }
+}
+
+void PooledProcessor::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    if (!frame || !inner_) {
+        return;
+    }
+
+    // The rectangles of a frame that was not queued are not included in this one. Frames the pool drops
+    // after queueing are reported by the pool itself, keyed by this stage's id. The frame is shared with
+    // other sinks, so the wrapped processor is told instead of clearing its rectangles.
+    bool not_queued = damage_lost_.exchange(false);
+
+    // The task keeps the inner processor alive; once Cleanup() detached the relay its output goes nowhere
+    auto inner = inner_;
+    auto heartbeat = heartbeat_;
+    int64_t queued_ns = FrameTracer::IsEnabled() ? FrameTracer::Now() : 0;
+    auto task = [inner, heartbeat, frame, queued_ns, not_queued](bool dropped_in_pool) {
+        if (queued_ns) {
+            FrameTracer::Record("pool queue wait", TraceCategory::QUEUE, frame->timestamp, queued_ns,
+                                FrameTracer::Now());
+        }
+        FrameTracer::Span span(typeid(*inner).name(), TraceCategory::PROCESS, frame->timestamp);
+        StageCounters::Scope counters(inner->GetId());
+        StageHeartbeat::WorkScope work(heartbeat.get());
+        if (not_queued || dropped_in_pool) {
+            inner->OnFramesDropped();
+        }
+        inner->OnFrame(frame);
+    };
+    if (!pool_->Submit(session_id_, task, frame, GetId())) {
+        damage_lost_ = true;
+        LOG_WARN("Session %s is not registered in the worker pool, dropping frame", session_id_.c_str());
+    }
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,73 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_POOLED_PROCESSOR_H
+#define LMSHAO_REMOTE_DESK_POOLED_PROCESSOR_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "../core/media_processor.h"
+#include "../core/session_worker_pool.h"
+#include "../core/stage_watchdog.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Runs a synchronous processor on a shared SessionWorkerPool
+ * OnFrame only queues the frame as a task of the session, the wrapped
+ * processor's OnFrame runs later on a pool worker. Frames it delivers are
+ * forwarded to the sinks of this wrapper, so it links into a Pipeline like
+ * the processor it wraps. After a frame is dropped, by the pool or because
+ * it could not be queued, the wrapped processor's OnFramesDropped() runs
+ * before the next frame, so incremental stages redo the whole frame.
+ */
+class PooledProcessor : public MediaProcessor {
+public:
+    PooledProcessor(std::shared_ptr<MediaProcessor> inner, std::shared_ptr<SessionWorkerPool> pool,
+                    const std::string &session_id);
+    ~PooledProcessor() override;
+
+    // MediaProcessor interface implementation
+    bool Initialize() override;
+    void Cleanup() override;
+    bool IsReady() const override { return inner_ && inner_->IsReady(); }
+    bool Start() override { return inner_ && inner_->Start(); }
+    void Stop() override;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+    void OnFramesDropped() override { damage_lost_ = true; } // Passed on with the next frame
+
+    std::shared_ptr<MediaProcessor> GetInner() const { return inner_; }
+
+private:
+    /**
+     * @brief Sink attached to the wrapped processor, hands its output back to this wrapper
+     */
+    class Relay : public ISink {
+    public:
+        explicit Relay(PooledProcessor *owner) : owner_(owner) {}
+        uint64_t GetId() const override { return reinterpret_cast<uint64_t>(this); }
+        void OnFrame(const std::shared_ptr<Frame> &frame) override { owner_->DeliverFrame(frame); }
+
+    private:
+        PooledProcessor *owner_;
+    };
+
+private:
+    std::shared_ptr<MediaProcessor> inner_;
+    std::shared_ptr<SessionWorkerPool> pool_;
+    std::string session_id_;
+    std::shared_ptr<Relay> relay_;
+    std::shared_ptr<StageHeartbeat> heartbeat_; // Busy while a task runs the wrapped processor
+    std::atomic<bool> damage_lost_{false};      // A frame was not queued, reported with the next one
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_POOLED_PROCESSOR_H
@@ -0,0 +1,101 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "simd_support.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(REMOTE_DESK_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(REMOTE_DESK_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return SimdLevel::SSSE3;
+    }
+#elif defined(REMOTE_DESK_X86_SIMD)
+    int info[4] = {};
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+    __cpuid(info, 1);
+    bool ssse3 = (info[2] & (1 << 9)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    bool avx512 = false;
+    if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        // AVX512F and AVX512BW, with the opmask and upper ZMM state enabled by the OS
+        avx512 = (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0 && (_xgetbv(0) & 0xE0) == 0xE0;
+    }
+    if (avx512) {
+        return SimdLevel::AVX512;
+    }
+    if (avx2) {
+        return SimdLevel::AVX2;
+    }
+    if (ssse3) {
+        return SimdLevel::SSSE3;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+std::atomic<int> &ActiveSimdLevel()
+{
+    static std::atomic<int> level{static_cast<int>(GetSupportedSimdLevel())};
+    return level;
+}
+
+} // namespace
+
+SimdLevel GetSupportedSimdLevel()
+{
+    static const SimdLevel supported = DetectSimdLevel();
+    return supported;
+}
+
+SimdLevel GetSimdLevel()
+{
+    return static_cast<SimdLevel>(ActiveSimdLevel().load(std::memory_order_relaxed));
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+    ActiveSimdLevel().store(static_cast<int>(std::min(level, GetSupportedSimdLevel())), std::memory_order_relaxed);
+}
+
+const char *GetSimdLevelName(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::SSSE3:
+            return "SSSE3";
+        default:
+            return "Scalar";
+    }
+}
+
+} // namespace lmshao::remotedesk
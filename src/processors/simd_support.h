@@ -0,0 +1,60 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_SIMD_SUPPORT_H
+#define LMSHAO_REMOTE_DESK_SIMD_SUPPORT_H
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define REMOTE_DESK_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// GCC and Clang compile each SIMD kernel for its own target, MSVC accepts the intrinsics anywhere
+#if defined(REMOTE_DESK_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define REMOTE_DESK_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define REMOTE_DESK_TARGET_AVX2 __attribute__((target("avx2")))
+#define REMOTE_DESK_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define REMOTE_DESK_TARGET_SSSE3
+#define REMOTE_DESK_TARGET_AVX2
+#define REMOTE_DESK_TARGET_AVX512
+#endif
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Instruction set used by the pixel kernels
+ */
+enum class SimdLevel {
+    SCALAR = 0,
+    SSSE3 = 1,  // pshufb, 16 bytes per shuffle
+    AVX2 = 2,   // vpshufb, two 16-byte lanes per shuffle
+    AVX512 = 3, // AVX-512BW vpshufb, four lanes; may lower the core clock, see KernelAutotuner
+};
+
+/**
+ * @brief Widest instruction set supported by this CPU (detected once)
+ * Not necessarily the fastest one, AVX-512 can cost more in clock speed than it gains.
+ */
+SimdLevel GetSupportedSimdLevel();
+
+/**
+ * @brief Instruction set the kernels currently use
+ */
+SimdLevel GetSimdLevel();
+
+/**
+ * @brief Restrict the kernels to an instruction set, clamped to what the CPU supports
+ */
+void SetSimdLevel(SimdLevel level);
+
+const char *GetSimdLevelName(SimdLevel level);
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_SIMD_SUPPORT_H
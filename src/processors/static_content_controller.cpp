@@ -0,0 +1,211 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "static_content_controller.h"
+
+#include <cstring>
+
+#include "../log/remote_desk_log.h"
+#include "packed_rgb_kernels.h"
+
+namespace lmshao::remotedesk {
+
+StaticContentController::StaticContentController(const StaticContentControllerConfig &config) : config_(config) {}
+
+StaticContentController::~StaticContentController()
+{
+    Stop();
+}
+
+void StaticContentController::SetEncoder(std::shared_ptr<VideoEncoder> encoder)
+{
+    std::lock_guard<std::mutex> lock(deliver_mutex_);
+    encoder_ = std::move(encoder);
+}
+
+void StaticContentController::SetConverter(std::shared_ptr<PixelFormatConverter> converter)
+{
+    std::lock_guard<std::mutex> lock(deliver_mutex_);
+    converter_ = std::move(converter);
+}
+
+bool StaticContentController::Initialize()
+{
+    if (config_.static_period.count() <= 0) {
+        LOG_ERROR("Invalid static period %lldms", static_cast<long long>(config_.static_period.count()));
+        return false;
+    }
+    return true;
+}
+
+bool StaticContentController::Start()
+{
+    if (running_) {
+        return true;
+    }
+    if (!encoder_) {
+        LOG_WARN("StaticContentController has no encoder, frames are only forwarded");
+    }
+
+    running_ = true;
+    timer_thread_ = std::thread(&StaticContentController::TimerThreadProc, this);
+    return true;
+}
+
+void StaticContentController::Stop()
+{
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(deliver_mutex_);
+        running_ = false;
+    }
+    timer_cv_.notify_all();
+    if (timer_thread_.joinable()) {
+        timer_thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(deliver_mutex_);
+    if (refining_) {
+        LeaveRefinement();
+    }
+    last_frame_.reset();
+}
+
+void StaticContentController::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    if (!frame) {
+        return;
+    }
+    if (!frame->IsVideo()) {
+        DeliverFrame(frame);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(deliver_mutex_);
+
+        // New content: back to 4:2:0 before the frame reaches the converter and encoder
+        if (refining_) {
+            LeaveRefinement();
+        }
+        last_frame_ = frame;
+        last_frame_time_ = std::chrono::steady_clock::now();
+        refined_ = false;
+
+        DeliverFrame(frame);
+    }
+    timer_cv_.notify_one();
+}
+
+bool StaticContentController::IsRefining() const
+{
+    std::lock_guard<std::mutex> lock(deliver_mutex_);
+    return refining_;
+}
+
+StaticContentController::RefinementStats StaticContentController::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void StaticContentController::TimerThreadProc()
+{
+    std::unique_lock<std::mutex> lock(deliver_mutex_);
+    while (running_) {
+        if (refined_ || !last_frame_ || !encoder_) {
+            timer_cv_.wait(lock);
+            continue;
+        }
+
+        auto deadline = last_frame_time_ + config_.static_period;
+        if (std::chrono::steady_clock::now() < deadline) {
+            timer_cv_.wait_until(lock, deadline);
+            continue;
+        }
+
+        refined_ = true;
+        EnterRefinement();
+    }
+}
+
+void StaticContentController::EnterRefinement()
+{
+    saved_encoder_config_ = encoder_->GetConfig();
+    if (saved_encoder_config_.full_chroma && (saved_encoder_config_.lossless || !config_.lossless)) {
+        return; // Configured for full quality already
+    }
+    if (saved_encoder_config_.bit_depth > 8) {
+        return; // 10-bit streams are H265 Main10, which has no 4:4:4 refinement here
+    }
+    if (converter_ && !HasPackedRgbToYuvKernel(last_frame_->format, FrameFormat::I444)) {
+        return; // No 4:4:4 kernel for this source, e.g. X2RGB10 feeding an 8-bit stream
+    }
+
+    VideoEncoderConfig refined = saved_encoder_config_;
+    refined.full_chroma = true;
+    refined.lossless = config_.lossless;
+    if (converter_) {
+        saved_converter_format_ = converter_->GetOutputFormat();
+        if (converter_->SetOutputFormat(FrameFormat::I444)) {
+            refined.input_format = FrameFormat::I444;
+        }
+    }
+
+    if (!encoder_->UpdateConfig(refined)) {
+        LOG_WARN("Encoder rejected the full-chroma configuration, static content stays at 4:2:0");
+        if (converter_) {
+            converter_->SetOutputFormat(saved_converter_format_);
+        }
+        return;
+    }
+    refining_ = true;
+
+    // Same picture again with a fresh timestamp, converted whole and encoded by the reopened encoder
+    auto frame = std::make_shared<Frame>(last_frame_->Size());
+    frame->SetSize(last_frame_->Size());
+    std::memcpy(frame->Data(), last_frame_->Data(), last_frame_->Size());
+    frame->format = last_frame_->format;
+    frame->video_info = last_frame_->video_info;
+    frame->stride = last_frame_->stride;
+    frame->timestamp =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+
+    LOG_DEBUG("Screen static for %lldms, refining with %s 4:4:4", static_cast<long long>(config_.static_period.count()),
+              config_.lossless ? "lossless" : "lossy");
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.refinements++;
+    }
+    DeliverFrame(frame);
+}
+
+void StaticContentController::LeaveRefinement()
+{
+    // Only the refinement fields are restored, other changes made meanwhile (e.g. bitrate) are kept
+    VideoEncoderConfig restored = encoder_->GetConfig();
+    restored.full_chroma = saved_encoder_config_.full_chroma;
+    restored.lossless = saved_encoder_config_.lossless;
+    restored.input_format = saved_encoder_config_.input_format;
+    if (converter_) {
+        converter_->SetOutputFormat(saved_converter_format_);
+    }
+    if (!encoder_->UpdateConfig(restored)) {
+        LOG_ERROR("Failed to restore the encoder configuration after refinement");
+    }
+    refining_ = false;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.refinements_left++;
+}
+
+} // namespace lmshao::remotedesk
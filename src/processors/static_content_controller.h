@@ -0,0 +1,118 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_STATIC_CONTENT_CONTROLLER_H
+#define LMSHAO_REMOTE_DESK_STATIC_CONTENT_CONTROLLER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../core/media_processor.h"
+#include "pixel_format_converter.h"
+#include "video_encoder.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Static content controller configuration
+ */
+struct StaticContentControllerConfig {
+    std::chrono::milliseconds static_period{1000}; // No new frame for this long counts as a static screen
+    bool lossless = true;                          // Refine with qp=0, otherwise only switch to 4:4:4
+};
+
+/**
+ * @brief Refines a static screen with full-chroma, optionally lossless, encoding
+ * Sits between the screen capturer and the converter/encoder chain and forwards
+ * frames unchanged. Damage driven capture engines stop delivering frames while
+ * nothing changes; once no frame arrived for static_period, the bound encoder is
+ * reopened with full_chroma (and lossless), a bound converter switches to I444,
+ * and the last captured frame is sent again to be encoded at full quality. The
+ * next captured frame restores the previous configuration before it is forwarded,
+ * so motion is encoded at the usual 4:2:0 bitrate.
+ */
+class StaticContentController : public MediaProcessor {
+public:
+    explicit StaticContentController(const StaticContentControllerConfig &config = {});
+    ~StaticContentController() override;
+
+    /**
+     * @brief Encoder switched to full chroma during static periods (before Start)
+     */
+    void SetEncoder(std::shared_ptr<VideoEncoder> encoder);
+
+    /**
+     * @brief Converter in front of the encoder, switched between its output format and I444 (optional)
+     */
+    void SetConverter(std::shared_ptr<PixelFormatConverter> converter);
+
+    // MediaProcessor interface implementation
+    bool Initialize() override;
+    bool Start() override;
+    void Stop() override;
+    bool IsRunning() const override { return running_; }
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+
+    /**
+     * @brief Whether the encoder currently runs the full-chroma refinement configuration
+     */
+    bool IsRefining() const;
+
+    struct RefinementStats {
+        uint64_t refinements = 0;      // Static periods refined
+        uint64_t refinements_left = 0; // Refinements ended by new content
+    };
+    RefinementStats GetStats() const;
+
+private:
+    /**
+     * @brief Timer thread: refine once the screen was static for static_period
+     */
+    void TimerThreadProc();
+
+    /**
+     * @brief Reconfigure for full chroma and send the last frame again (deliver_mutex_ held)
+     */
+    void EnterRefinement();
+
+    /**
+     * @brief Restore the configuration saved by EnterRefinement() (deliver_mutex_ held)
+     */
+    void LeaveRefinement();
+
+private:
+    StaticContentControllerConfig config_;
+    std::shared_ptr<VideoEncoder> encoder_;
+    std::shared_ptr<PixelFormatConverter> converter_;
+
+    // Serializes forwarded frames with the refinement frame and the reconfiguration
+    mutable std::mutex deliver_mutex_;
+    std::shared_ptr<Frame> last_frame_;
+    std::chrono::steady_clock::time_point last_frame_time_;
+    bool refining_ = false;
+    bool refined_ = false; // The current static period was refined already
+    VideoEncoderConfig saved_encoder_config_;
+    FrameFormat saved_converter_format_ = FrameFormat::UNKNOWN;
+
+    // Timer thread
+    std::thread timer_thread_;
+    std::condition_variable timer_cv_;
+    std::atomic<bool> running_{false};
+
+    // Statistics
+    mutable std::mutex stats_mutex_;
+    RefinementStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_STATIC_CONTENT_CONTROLLER_H
@@ -0,0 +1,58 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "temporal_layer_filter.h"
+
+namespace lmshao::remotedesk {
+
+TemporalLayerFilter::TemporalLayerFilter(uint8_t max_temporal_id)
+    : max_temporal_id_(max_temporal_id), active_max_temporal_id_(max_temporal_id)
+{
+}
+
+void TemporalLayerFilter::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    if (frame && Accept(*frame)) {
+        DeliverFrame(frame);
+    }
+}
+
+bool TemporalLayerFilter::Accept(const Frame &frame)
+{
+    if (!frame.IsVideo()) {
+        return true;
+    }
+
+    // Switch up only where no frame depends on a picture dropped under the old limit
+    uint8_t requested = max_temporal_id_.load();
+    if (requested < active_max_temporal_id_ ||
+        (requested > active_max_temporal_id_ && (frame.video_info.is_keyframe || frame.video_info.temporal_id == 0))) {
+        active_max_temporal_id_ = requested;
+    }
+
+    // Keyframes always pass; they are base layer frames anyway
+    bool forward = frame.video_info.is_keyframe || frame.video_info.temporal_id <= active_max_temporal_id_;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        if (forward) {
+            stats_.frames_forwarded++;
+        } else {
+            stats_.frames_dropped++;
+        }
+    }
+    return forward;
+}
+
+TemporalLayerFilter::FilterStats TemporalLayerFilter::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace lmshao::remotedesk
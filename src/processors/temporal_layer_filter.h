@@ -0,0 +1,66 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_TEMPORAL_LAYER_FILTER_H
+#define LMSHAO_REMOTE_DESK_TEMPORAL_LAYER_FILTER_H
+
+#include <atomic>
+#include <mutex>
+
+#include "../core/media_processor.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Per-client frame rate thinning of a temporally layered stream
+ * Sits between the shared encoder and a client's sender and drops encoded
+ * frames whose temporal_id is above the client's limit. No decoding or
+ * re-encoding is involved, so any number of clients can run at different
+ * frame rates off one encode. Lowering the limit takes effect immediately.
+ * Raising it waits for the next base layer frame or keyframe: frames of the
+ * newly allowed layers before that may reference pictures the client never
+ * received.
+ */
+class TemporalLayerFilter : public MediaProcessor {
+public:
+    explicit TemporalLayerFilter(uint8_t max_temporal_id = UINT8_MAX);
+    ~TemporalLayerFilter() override = default;
+
+    // MediaProcessor interface implementation
+    bool Initialize() override { return true; }
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+
+    /**
+     * @brief Whether the frame passes the current limit (counted in the stats, used by StaticPipeline)
+     */
+    bool Accept(const Frame &frame);
+
+    /**
+     * @brief Highest temporal layer forwarded to the sinks (0 = base layer only)
+     */
+    void SetMaxTemporalId(uint8_t max_temporal_id) { max_temporal_id_ = max_temporal_id; }
+    uint8_t GetMaxTemporalId() const { return max_temporal_id_; }
+
+    struct FilterStats {
+        uint64_t frames_forwarded = 0;
+        uint64_t frames_dropped = 0;
+    };
+    FilterStats GetStats() const;
+
+private:
+    std::atomic<uint8_t> max_temporal_id_; // Requested limit
+    uint8_t active_max_temporal_id_;       // Limit in effect, only touched by Accept()
+
+    // Statistics
+    mutable std::mutex stats_mutex_;
+    FilterStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_TEMPORAL_LAYER_FILTER_H
@@ -0,0 +1,86 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "temporal_layer_structure.h"
+
+#include <algorithm>
+
+namespace lmshao::remotedesk {
+
+TemporalLayerStructure::TemporalLayerStructure(uint8_t layer_count)
+    : layer_count_(std::clamp<uint8_t>(layer_count, 1, MAX_LAYERS))
+{
+    switch (layer_count_) {
+        case 2:
+            pattern_ = {0, 1};
+            break;
+        case 3:
+            pattern_ = {0, 2, 1, 2};
+            break;
+        default:
+            pattern_ = {0};
+            break;
+    }
+}
+
+TemporalLayerStructure::FrameConfig TemporalLayerStructure::NextFrame()
+{
+    size_t index = position_;
+    position_ = (position_ + 1) % pattern_.size();
+
+    FrameConfig frame;
+    frame.temporal_id = pattern_[index];
+    if (layer_count_ == 1) {
+        return frame;
+    }
+
+    // LAST holds the newest TL0 frame, GOLDEN the newest TL1 frame (L1T3 only), ALTREF is left
+    // to LongTermReferenceController
+    using Flags = VpxRefFlags;
+    if (frame.temporal_id == 0) {
+        frame.vpx_flags = Flags::NO_REF_GF | Flags::NO_REF_ARF | Flags::NO_UPD_GF | Flags::NO_UPD_ARF;
+    } else if (frame.temporal_id + 1 < layer_count_) {
+        // TL1 of L1T3: predicted from TL0, stored in GOLDEN for the TL2 frame that follows
+        frame.vpx_flags = Flags::NO_REF_GF | Flags::NO_REF_ARF | Flags::NO_UPD_LAST | Flags::NO_UPD_ARF;
+    } else if (layer_count_ == 3 && index == 3) {
+        // Second TL2 frame of the period: GOLDEN (TL1) is the nearest frame
+        frame.vpx_flags = Flags::NO_REF_LAST | Flags::NO_REF_ARF | Flags::NO_UPD_ALL;
+    } else {
+        // Top layer: predicted from TL0 and never referenced itself
+        frame.vpx_flags = Flags::NO_REF_GF | Flags::NO_REF_ARF | Flags::NO_UPD_ALL;
+    }
+    return frame;
+}
+
+uint32_t TemporalLayerStructure::GetFrameRateDivisor(uint8_t max_temporal_id) const
+{
+    if (max_temporal_id + 1 >= layer_count_) {
+        return 1;
+    }
+    return 1u << (layer_count_ - 1 - max_temporal_id);
+}
+
+std::string TemporalLayerStructure::BuildVpxTsParameters(uint32_t bitrate) const
+{
+    // Target bitrates are cumulative (layer N includes all layers below it) and given in kbps
+    uint32_t kbps = std::max(1u, bitrate / 1000);
+    std::string params = "ts_number_layers=" + std::to_string(layer_count_);
+    if (layer_count_ == 2) {
+        params += ":ts_target_bitrate=" + std::to_string(kbps * 7 / 10) + "," + std::to_string(kbps);
+        params += ":ts_rate_decimator=2,1:ts_periodicity=2:ts_layer_id=0,1";
+    } else if (layer_count_ == 3) {
+        params += ":ts_target_bitrate=" + std::to_string(kbps * 6 / 10) + "," + std::to_string(kbps * 8 / 10) +
+                  "," + std::to_string(kbps);
+        params += ":ts_rate_decimator=4,2,1:ts_periodicity=4:ts_layer_id=0,2,1,2";
+    } else {
+        params += ":ts_target_bitrate=" + std::to_string(kbps);
+    }
+    return params;
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,90 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_TEMPORAL_LAYER_STRUCTURE_H
+#define LMSHAO_REMOTE_DESK_TEMPORAL_LAYER_STRUCTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief libvpx per-frame reference control, mirrors VP8_EFLAG_* from vpx/vp8cx.h
+ * Passed through the "vp8-flags" frame metadata; libvpx-vp9 honours the same
+ * flags outside of SVC mode. Reference buffers are LAST, GOLDEN (GF) and ALTREF (ARF).
+ */
+struct VpxRefFlags {
+    static constexpr uint32_t NO_REF_LAST = 1u << 16;
+    static constexpr uint32_t NO_REF_GF = 1u << 17;
+    static constexpr uint32_t NO_UPD_LAST = 1u << 18;
+    static constexpr uint32_t NO_REF_ARF = 1u << 21;
+    static constexpr uint32_t NO_UPD_GF = 1u << 22;
+    static constexpr uint32_t NO_UPD_ARF = 1u << 23;
+    static constexpr uint32_t NO_UPD_ALL = NO_UPD_LAST | NO_UPD_GF | NO_UPD_ARF;
+};
+
+/**
+ * @brief Single spatial layer temporal scalability pattern (L1T1, L1T2, L1T3)
+ * Decides the temporal layer of every encoded frame and the libvpx reference
+ * flags that keep upper layers droppable: a frame only references frames of
+ * its own or a lower layer, and frames of the top layer are never referenced.
+ * Dropping layers above N therefore leaves a decodable stream at
+ * fps / GetFrameRateDivisor(N).
+ *
+ *   L1T2: 0 1 0 1 ...
+ *   L1T3: 0 2 1 2 0 2 1 2 ...
+ */
+class TemporalLayerStructure {
+public:
+    static constexpr uint8_t MAX_LAYERS = 3;
+
+    struct FrameConfig {
+        uint8_t temporal_id = 0;
+        uint32_t vpx_flags = 0; // VpxRefFlags for the "vp8-flags" frame metadata
+        bool long_term_reference = false; // Stored in a long-term slot, receivers should acknowledge it
+    };
+
+    /**
+     * @param layer_count Number of temporal layers, clamped to 1..MAX_LAYERS
+     */
+    explicit TemporalLayerStructure(uint8_t layer_count = 1);
+
+    uint8_t GetLayerCount() const { return layer_count_; }
+
+    /**
+     * @brief Configuration of the next frame in encode order
+     */
+    FrameConfig NextFrame();
+
+    /**
+     * @brief Restart the pattern, called when a keyframe is forced
+     */
+    void Reset() { position_ = 0; }
+
+    /**
+     * @brief Frame rate divisor seen by a receiver that keeps layers 0..max_temporal_id
+     */
+    uint32_t GetFrameRateDivisor(uint8_t max_temporal_id) const;
+
+    /**
+     * @brief libvpx "ts-parameters" option value for this pattern
+     * Bitrate is split 60/20/20 (L1T3) or 70/30 (L1T2) across the layers.
+     */
+    std::string BuildVpxTsParameters(uint32_t bitrate) const;
+
+private:
+    uint8_t layer_count_;
+    std::vector<uint8_t> pattern_;
+    size_t position_ = 0;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_TEMPORAL_LAYER_STRUCTURE_H
@@ -0,0 +1,265 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "video_codec_backend.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <thread>
+
+#include "../log/remote_desk_log.h"
+#include "video_encoder.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+const AVCodec *FindFirstEncoder(std::initializer_list<const char *> names, AVCodecID fallback)
+{
+    for (const char *name : names) {
+        const AVCodec *codec = avcodec_find_encoder_by_name(name);
+        if (codec) {
+            return codec;
+        }
+    }
+    return avcodec_find_encoder(fallback);
+}
+
+bool IsEncoder(const AVCodec *codec, const char *name)
+{
+    return codec && codec->name && std::string(codec->name) == name;
+}
+
+//==============================================================================
+// H264 (libx264)
+//==============================================================================
+class H264CodecBackend : public VideoCodecBackend {
+public:
+    const char *GetName() const override { return "H264"; }
+    FrameFormat GetOutputFormat() const override { return FrameFormat::H264; }
+
+    const AVCodec *FindEncoder() const override { return FindFirstEncoder({"libx264"}, AV_CODEC_ID_H264); }
+
+    bool SupportsIntraRefresh() const override { return IsEncoder(FindEncoder(), "libx264"); }
+
+    AVPixelFormat GetPixelFormat(const VideoEncoderConfig &config) const override
+    {
+        // High 4:4:4 Predictive is a libx264 feature, other H264 encoders stay at 4:2:0
+        if ((config.full_chroma || config.lossless) && IsEncoder(FindEncoder(), "libx264")) {
+            return AV_PIX_FMT_YUV444P;
+        }
+        return AV_PIX_FMT_YUV420P;
+    }
+
+    bool Configure(AVCodecContext *ctx, const AVCodec *codec, const VideoEncoderConfig &config,
+                   AVDictionary **options) const override
+    {
+        ConfigureCommon(ctx, config);
+
+        if (IsEncoder(codec, "libx264")) {
+            static const char *presets[] = {"ultrafast", "superfast", "veryfast"};
+            av_dict_set(options, "preset", presets[static_cast<int>(config.speed_preset)], 0);
+            av_dict_set(options, "tune", "zerolatency", 0);
+            if (config.intra_refresh) {
+                // Periodic intra refresh: forced keyframes start a refresh wave instead of an IDR
+                av_dict_set(options, "intra-refresh", "1", 0);
+                av_dict_set(options, "forced-idr", "0", 0);
+            } else {
+                // Forced keyframes are IDRs, which a context reused from EncoderContextPool relies on
+                av_dict_set(options, "forced-idr", "1", 0);
+            }
+            if (config.full_chroma || config.lossless) {
+                av_dict_set(options, "profile", "high444", 0);
+            }
+            if (config.lossless) {
+                // Constant qp 0 is mathematically lossless; libx264 only honours qp without a target bitrate
+                ctx->bit_rate = 0;
+                av_dict_set(options, "qp", "0", 0);
+            }
+        }
+        return true;
+    }
+};
+
+//==============================================================================
+// H265 (libx265)
+//==============================================================================
+class H265CodecBackend : public VideoCodecBackend {
+public:
+    const char *GetName() const override { return "H265"; }
+    FrameFormat GetOutputFormat() const override { return FrameFormat::H265; }
+
+    const AVCodec *FindEncoder() const override { return FindFirstEncoder({"libx265"}, AV_CODEC_ID_HEVC); }
+
+    AVPixelFormat GetPixelFormat(const VideoEncoderConfig &config) const override
+    {
+        // libx265 builds with multilib support select the 10-bit encoder from the pixel format
+        if (config.bit_depth > 8 && IsEncoder(FindEncoder(), "libx265")) {
+            return AV_PIX_FMT_YUV420P10LE;
+        }
+        return AV_PIX_FMT_YUV420P;
+    }
+
+    bool Configure(AVCodecContext *ctx, const AVCodec *codec, const VideoEncoderConfig &config,
+                   AVDictionary **options) const override
+    {
+        ConfigureCommon(ctx, config);
+
+        if (!IsEncoder(codec, "libx265")) {
+            return true;
+        }
+
+        static const char *presets[] = {"ultrafast", "superfast", "veryfast"};
+        av_dict_set(options, "preset", presets[static_cast<int>(config.speed_preset)], 0);
+        av_dict_set(options, "tune", "zerolatency", 0);
+        // Without it libx265 turns AV_PICTURE_TYPE_I into an open GOP CRA, not an IDR
+        av_dict_set(options, "forced-idr", "1", 0);
+        if (config.bit_depth > 8) {
+            av_dict_set(options, "profile", "main10", 0);
+        }
+
+        // WPP keeps every core busy within a single frame without adding latency. Frame
+        // threads pipeline consecutive frames, which costs latency, so a second one is
+        // only used on hosts where WPP alone cannot occupy the worker pool.
+        int threads = ResolveThreadCount(config);
+        int frame_threads = threads >= 16 ? 2 : 1;
+        std::string params = "wpp=1:pools=" + std::to_string(threads) + ":frame-threads=" +
+                             std::to_string(frame_threads) + ":bframes=0:rc-lookahead=0:repeat-headers=1:info=0";
+        if (config.screen_content) {
+            // SAO smooths ringing around edges, which blurs thin text strokes
+            params += ":sao=0";
+        }
+        av_dict_set(options, "x265-params", params.c_str(), 0);
+        return true;
+    }
+};
+
+//==============================================================================
+// VP8 / VP9 (libvpx)
+//==============================================================================
+class VpxCodecBackend : public VideoCodecBackend {
+public:
+    explicit VpxCodecBackend(bool vp9) : vp9_(vp9) {}
+
+    const char *GetName() const override { return vp9_ ? "VP9" : "VP8"; }
+    FrameFormat GetOutputFormat() const override { return vp9_ ? FrameFormat::VP9 : FrameFormat::VP8; }
+
+    const AVCodec *FindEncoder() const override
+    {
+        return vp9_ ? FindFirstEncoder({"libvpx-vp9"}, AV_CODEC_ID_VP9)
+                    : FindFirstEncoder({"libvpx"}, AV_CODEC_ID_VP8);
+    }
+
+    bool SupportsTemporalLayers() const override { return true; }
+
+    bool Configure(AVCodecContext *ctx, const AVCodec *codec, const VideoEncoderConfig &config,
+                   AVDictionary **options) const override
+    {
+        ConfigureCommon(ctx, config);
+
+        if (!IsEncoder(codec, vp9_ ? "libvpx-vp9" : "libvpx")) {
+            return true;
+        }
+
+        // Constant bitrate with no lookahead: every frame is emitted as soon as it is encoded
+        ctx->rc_min_rate = ctx->bit_rate;
+        ctx->rc_max_rate = ctx->bit_rate;
+        ctx->rc_buffer_size = static_cast<int>(ctx->bit_rate); // ~1 second buffer
+        av_dict_set(options, "deadline", "realtime", 0);
+        av_dict_set(options, "lag-in-frames", "0", 0);
+
+        // VP8 accepts cpu-used up to 16 in realtime mode, VP9 up to 8
+        static const int vp8_speed[] = {12, 8, 4};
+        static const int vp9_speed[] = {8, 7, 5};
+        int preset = static_cast<int>(config.speed_preset);
+        av_dict_set_int(options, "cpu-used", vp9_ ? vp9_speed[preset] : vp8_speed[preset], 0);
+
+        if (vp9_) {
+            // Row-based multithreading plus tile columns (each tile at least 256 pixels wide)
+            int threads = ResolveThreadCount(config);
+            int max_log2_tiles = 0;
+            while ((config.width >> (max_log2_tiles + 1)) >= 256 && (1 << (max_log2_tiles + 1)) <= threads) {
+                max_log2_tiles++;
+            }
+            av_dict_set(options, "row-mt", "1", 0);
+            av_dict_set_int(options, "tile-columns", max_log2_tiles, 0);
+            av_dict_set(options, "frame-parallel", "0", 0);
+            av_dict_set(options, "aq-mode", "3", 0); // Cyclic refresh, recommended for realtime
+            if (config.screen_content) {
+                av_dict_set(options, "tune-content", "screen", 0);
+            }
+        } else {
+            if (config.screen_content) {
+                av_dict_set(options, "screen-content-mode", "1", 0);
+            }
+            av_dict_set(options, "static-thresh", "100", 0); // Skip encoding of unchanged blocks
+        }
+
+        if (config.temporal_layers > 1) {
+            // Per-layer rate control; the layer of each frame is chosen by VideoEncoder through frame metadata
+            TemporalLayerStructure layers(config.temporal_layers);
+            av_dict_set(options, "ts-parameters", layers.BuildVpxTsParameters(config.bitrate).c_str(), 0);
+        }
+        return true;
+    }
+
+private:
+    bool vp9_;
+};
+
+} // namespace
+
+std::unique_ptr<VideoCodecBackend> VideoCodecBackend::Create(FrameFormat output_format)
+{
+    switch (output_format) {
+        case FrameFormat::H264:
+            return std::make_unique<H264CodecBackend>();
+        case FrameFormat::H265:
+            return std::make_unique<H265CodecBackend>();
+        case FrameFormat::VP8:
+            return std::make_unique<VpxCodecBackend>(false);
+        case FrameFormat::VP9:
+            return std::make_unique<VpxCodecBackend>(true);
+        default:
+            LOG_ERROR("No video codec backend for output format %d", static_cast<int>(output_format));
+            return nullptr;
+    }
+}
+
+AVPixelFormat VideoCodecBackend::GetPixelFormat(const VideoEncoderConfig &config) const
+{
+    (void)config;
+    return AV_PIX_FMT_YUV420P;
+}
+
+void VideoCodecBackend::ConfigureCommon(AVCodecContext *ctx, const VideoEncoderConfig &config) const
+{
+    int fps = static_cast<int>(std::max(1u, config.fps));
+
+    ctx->width = static_cast<int>(config.width);
+    ctx->height = static_cast<int>(config.height);
+    ctx->time_base = {1, fps};
+    ctx->framerate = {fps, 1};
+    ctx->pix_fmt = GetPixelFormat(config);
+    ctx->bit_rate = config.bitrate;
+    ctx->gop_size = static_cast<int>(config.keyframe_interval);
+    ctx->max_b_frames = 0; // B-frames add a frame of latency
+    ctx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    ctx->thread_count = ResolveThreadCount(config);
+}
+
+int VideoCodecBackend::ResolveThreadCount(const VideoEncoderConfig &config)
+{
+    if (config.thread_count > 0) {
+        return static_cast<int>(config.thread_count);
+    }
+    return static_cast<int>(std::max(1u, std::min(std::thread::hardware_concurrency(), 8u)));
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,105 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_VIDEO_CODEC_BACKEND_H
+#define LMSHAO_REMOTE_DESK_VIDEO_CODEC_BACKEND_H
+
+#include <memory>
+
+#include "../core/frame.h"
+
+// FFmpeg headers
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/dict.h>
+}
+
+namespace lmshao::remotedesk {
+
+struct VideoEncoderConfig;
+
+/**
+ * @brief Codec-neutral speed presets, mapped to x264/x265 presets or libvpx cpu-used levels
+ */
+enum class EncoderSpeedPreset {
+    ULTRA_FAST = 0, // Lowest CPU, lowest compression efficiency
+    FAST = 1,       // Good trade-off for interactive desktops
+    BALANCED = 2    // Better compression, noticeably more CPU
+};
+
+/**
+ * @brief Codec specific part of VideoEncoder
+ * Selected from VideoEncoderConfig::output_format. A backend knows which
+ * libavcodec encoder to open and which private options give low-latency
+ * realtime behaviour for that codec; everything else (queueing, packet
+ * handling, statistics) stays in VideoEncoder.
+ */
+class VideoCodecBackend {
+public:
+    virtual ~VideoCodecBackend() = default;
+
+    /**
+     * @brief Create the backend for an encoded output format
+     * @return nullptr if the format is not a supported video codec
+     */
+    static std::unique_ptr<VideoCodecBackend> Create(FrameFormat output_format);
+
+    /**
+     * @brief Human-readable backend name for logging
+     */
+    virtual const char *GetName() const = 0;
+
+    /**
+     * @brief Encoded format produced by this backend
+     */
+    virtual FrameFormat GetOutputFormat() const = 0;
+
+    /**
+     * @brief Find the preferred libavcodec encoder, falling back to the native one
+     */
+    virtual const AVCodec *FindEncoder() const = 0;
+
+    /**
+     * @brief Pixel format the encoder is opened with
+     */
+    virtual AVPixelFormat GetPixelFormat(const VideoEncoderConfig &config) const;
+
+    /**
+     * @brief Whether per-frame temporal layer control ("temporal_id"/"vp8-flags" frame metadata) is honoured
+     * Backends without it encode a single layer whatever VideoEncoderConfig::temporal_layers says.
+     */
+    virtual bool SupportsTemporalLayers() const { return false; }
+
+    /**
+     * @brief Whether forced keyframes become intra refresh waves when VideoEncoderConfig::intra_refresh is set
+     */
+    virtual bool SupportsIntraRefresh() const { return false; }
+
+    /**
+     * @brief Fill codec context fields and private options before avcodec_open2()
+     * @param codec Encoder returned by FindEncoder()
+     * @param options Private encoder options, passed to avcodec_open2()
+     */
+    virtual bool Configure(AVCodecContext *ctx, const AVCodec *codec, const VideoEncoderConfig &config,
+                           AVDictionary **options) const = 0;
+
+protected:
+    /**
+     * @brief Settings shared by all backends: geometry, timing, rate control and threads
+     */
+    void ConfigureCommon(AVCodecContext *ctx, const VideoEncoderConfig &config) const;
+
+    /**
+     * @brief Resolve VideoEncoderConfig::thread_count (0 = auto)
+     */
+    static int ResolveThreadCount(const VideoEncoderConfig &config);
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_VIDEO_CODEC_BACKEND_H
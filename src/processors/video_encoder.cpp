@@ -0,0 +1,666 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "video_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../log/remote_desk_log.h"
+#include "encoder_context_pool.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+// Frames waiting for the encoding thread beyond this are dropped, oldest first
+constexpr size_t MAX_QUEUED_FRAMES = 3;
+
+AVPixelFormat ToAVPixelFormat(FrameFormat format)
+{
+    switch (format) {
+        case FrameFormat::I420:
+            return AV_PIX_FMT_YUV420P;
+        case FrameFormat::NV12:
+            return AV_PIX_FMT_NV12;
+        case FrameFormat::I444:
+            return AV_PIX_FMT_YUV444P;
+        case FrameFormat::I010:
+            return AV_PIX_FMT_YUV420P10LE;
+        case FrameFormat::RGB24:
+            return AV_PIX_FMT_RGB24;
+        case FrameFormat::BGR24:
+            return AV_PIX_FMT_BGR24;
+        case FrameFormat::RGBA32:
+            return AV_PIX_FMT_RGBA;
+        case FrameFormat::BGRA32:
+            return AV_PIX_FMT_BGRA;
+        case FrameFormat::X2RGB10:
+            return AV_PIX_FMT_X2RGB10LE;
+        default:
+            return AV_PIX_FMT_NONE;
+    }
+}
+
+bool IsPackedFormat(FrameFormat format)
+{
+    switch (format) {
+        case FrameFormat::RGB24:
+        case FrameFormat::BGR24:
+        case FrameFormat::RGBA32:
+        case FrameFormat::BGRA32:
+        case FrameFormat::X2RGB10:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Whether switching from a to b only changes the bitrate, which an open encoder can follow
+bool DiffersOnlyInBitrate(const VideoEncoderConfig &a, const VideoEncoderConfig &b)
+{
+    return a.width == b.width && a.height == b.height && a.fps == b.fps &&
+           a.keyframe_interval == b.keyframe_interval && a.input_format == b.input_format &&
+           a.output_format == b.output_format && a.speed_preset == b.speed_preset &&
+           a.screen_content == b.screen_content && a.thread_count == b.thread_count &&
+           a.use_context_pool == b.use_context_pool && a.temporal_layers == b.temporal_layers &&
+           a.long_term_references == b.long_term_references && a.ltr_refresh_interval == b.ltr_refresh_interval &&
+           a.intra_refresh == b.intra_refresh && a.full_chroma == b.full_chroma && a.lossless == b.lossless &&
+           a.bit_depth == b.bit_depth;
+}
+
+} // namespace
+
+VideoEncoder::VideoEncoder(const VideoEncoderConfig &config)
+    : config_(config), keyframe_arbiter_(config.keyframe_arbiter)
+{
+    LOG_DEBUG("VideoEncoder created: %ux%u@%u, %u bps, format %d", config_.width, config_.height, config_.fps,
+              config_.bitrate, static_cast<int>(config_.output_format));
+}
+
+VideoEncoder::~VideoEncoder()
+{
+    Stop();
+
+    std::lock_guard<std::mutex> lock(encode_mutex_);
+    CleanupFFmpeg();
+    LOG_DEBUG("VideoEncoder destroyed");
+}
+
+bool VideoEncoder::Initialize()
+{
+    std::lock_guard<std::mutex> lock(encode_mutex_);
+    if (codec_ctx_) {
+        return true;
+    }
+    return InitializeFFmpeg();
+}
+
+bool VideoEncoder::Start()
+{
+    if (running_) {
+        return true;
+    }
+    if (!Initialize()) {
+        return false;
+    }
+
+    last_stats_time_ = std::chrono::steady_clock::now();
+    threaded_ = config_.use_encode_thread;
+    running_ = true;
+    if (threaded_) {
+        encode_thread_ = std::thread(&VideoEncoder::EncodeThreadFunc, this);
+    }
+    LOG_INFO("VideoEncoder started (%s)", threaded_ ? "encoding thread" : "encoding in OnFrame");
+    return true;
+}
+
+void VideoEncoder::Stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    queue_cv_.notify_all();
+    if (encode_thread_.joinable()) {
+        encode_thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    std::queue<std::shared_ptr<Frame>>().swap(encode_queue_);
+    LOG_INFO("VideoEncoder stopped");
+}
+
+bool VideoEncoder::IsRunning() const
+{
+    return running_;
+}
+
+void VideoEncoder::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_received++;
+    }
+
+    if (!running_ || !frame || !frame->IsValid() || !frame->IsVideo()) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_dropped++;
+        return;
+    }
+
+    if (!threaded_) {
+        EncodeFrame(frame);
+        return;
+    }
+
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        // A stale frame is worth least, keep the newest ones
+        while (encode_queue_.size() >= MAX_QUEUED_FRAMES) {
+            encode_queue_.pop();
+            dropped++;
+        }
+        encode_queue_.push(frame);
+    }
+    queue_cv_.notify_one();
+
+    if (dropped > 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_dropped += dropped;
+    }
+}
+
+bool VideoEncoder::UpdateConfig(const VideoEncoderConfig &config)
+{
+    std::lock_guard<std::mutex> lock(encode_mutex_);
+
+    if (codec_ctx_ && DiffersOnlyInBitrate(config_, config)) {
+        // Rate control follows bit_rate changes on an open context
+        config_.bitrate = config.bitrate;
+        codec_ctx_->bit_rate = config.bitrate;
+        return true;
+    }
+
+    // Everything else needs a new encoder; packets still buffered belong to the old stream
+    VideoEncoderConfig previous = config_;
+    CleanupFFmpeg();
+    if (config.temporal_layers != previous.temporal_layers ||
+        config.ltr_refresh_interval != previous.ltr_refresh_interval) {
+        // Slot layout depends on both; receivers have to be registered again
+        ltr_controller_.reset();
+    }
+    config_ = config;
+    config_.use_encode_thread = previous.use_encode_thread; // Applies from the next Start()
+    if (InitializeFFmpeg()) {
+        LOG_INFO("VideoEncoder reconfigured: %ux%u@%u, %u bps, format %d", config_.width, config_.height,
+                 config_.fps, config_.bitrate, static_cast<int>(config_.output_format));
+        return true;
+    }
+
+    LOG_ERROR("Failed to apply the new encoder configuration, keeping the previous one");
+    CleanupFFmpeg();
+    config_ = previous;
+    if (!InitializeFFmpeg()) {
+        LOG_ERROR("Failed to reopen the encoder with the previous configuration");
+    }
+    return false;
+}
+
+bool VideoEncoder::SetBitrate(uint32_t bitrate)
+{
+    if (bitrate == 0) {
+        LOG_ERROR("Invalid bitrate 0");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(encode_mutex_);
+    LOG_INFO("Setting bitrate from %u to %u", config_.bitrate, bitrate);
+    config_.bitrate = bitrate;
+    if (codec_ctx_) {
+        codec_ctx_->bit_rate = bitrate;
+        if (codec_ctx_->rc_max_rate > 0 && codec_ctx_->rc_max_rate == codec_ctx_->rc_min_rate) {
+            // Constant bitrate backends keep their rate window in step
+            codec_ctx_->rc_max_rate = bitrate;
+            codec_ctx_->rc_min_rate = bitrate;
+            codec_ctx_->rc_buffer_size = static_cast<int>(bitrate);
+        }
+    }
+    return true;
+}
+
+void VideoEncoder::ForceKeyFrame()
+{
+    force_keyframe_ = true;
+}
+
+void VideoEncoder::RequestKeyFrame(const std::string &receiver_id, KeyframeRequestReason reason)
+{
+    auto now = KeyframeArbiter::Clock::now();
+    auto delay = keyframe_arbiter_.Request(receiver_id, now, reason);
+    if (delay) {
+        keyframe_resolve_at_ = (now + *delay).time_since_epoch().count();
+    }
+}
+
+bool VideoEncoder::RequestRecovery()
+{
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex_);
+        if (ltr_controller_ && ltr_controller_->RequestRecovery()) {
+            return true;
+        }
+    }
+    ForceKeyFrame();
+    return false;
+}
+
+bool VideoEncoder::StartIntraRefresh()
+{
+    // With intra-refresh=1 libx264 answers a forced keyframe with a refresh wave, not an IDR
+    bool supported = SupportsIntraRefresh();
+    force_keyframe_ = true;
+    return supported;
+}
+
+void VideoEncoder::Flush()
+{
+    std::vector<std::shared_ptr<Frame>> outputs;
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex_);
+        if (!codec_ctx_) {
+            return;
+        }
+
+        // Drain, then reset the draining state; encoders that cannot be reset are reopened
+        if (avcodec_send_frame(codec_ctx_, nullptr) >= 0) {
+            ReceivePackets(outputs);
+        }
+        if (codec_ctx_->codec && (codec_ctx_->codec->capabilities & AV_CODEC_CAP_ENCODER_FLUSH)) {
+            avcodec_flush_buffers(codec_ctx_);
+        } else {
+            CleanupFFmpeg();
+            InitializeFFmpeg();
+        }
+        pending_frames_.clear();
+        force_keyframe_ = true;
+    }
+
+    for (auto &output : outputs) {
+        UpdateStats(output->Size(), std::chrono::milliseconds(0));
+        DeliverFrame(output);
+    }
+}
+
+VideoEncoder::EncodeStats VideoEncoder::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void VideoEncoder::EncodeThreadFunc()
+{
+    LOG_DEBUG("Encoding thread started");
+    while (running_) {
+        std::shared_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !encode_queue_.empty(); });
+            if (!running_) {
+                break;
+            }
+            frame = std::move(encode_queue_.front());
+            encode_queue_.pop();
+        }
+        EncodeFrame(frame);
+    }
+    LOG_DEBUG("Encoding thread stopped");
+}
+
+void VideoEncoder::ResolveKeyframeRequests()
+{
+    auto now = KeyframeArbiter::Clock::now();
+    int64_t resolve_at = keyframe_resolve_at_;
+    if (resolve_at == 0 || now.time_since_epoch().count() < resolve_at ||
+        !keyframe_resolve_at_.compare_exchange_strong(resolve_at, 0)) {
+        return;
+    }
+
+    bool ltr_available = false;
+    bool intra_refresh_available = false;
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex_);
+        ltr_available = ltr_controller_ && ltr_controller_->HasConfirmedReference();
+        intra_refresh_available = SupportsIntraRefresh();
+    }
+
+    auto decision = keyframe_arbiter_.Resolve(now, ltr_available, intra_refresh_available);
+    switch (decision.action) {
+        case RecoveryAction::LONG_TERM_REFERENCE:
+            RequestRecovery();
+            break;
+        case RecoveryAction::INTRA_REFRESH:
+            StartIntraRefresh();
+            break;
+        case RecoveryAction::KEYFRAME:
+            ForceKeyFrame();
+            break;
+        case RecoveryAction::NONE:
+            break;
+    }
+    if (decision.action != RecoveryAction::NONE) {
+        LOG_DEBUG("Keyframe requests of %zu receivers answered with action %d", decision.clients,
+                  static_cast<int>(decision.action));
+    }
+}
+
+void VideoEncoder::EncodeFrame(const std::shared_ptr<Frame> &frame)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Frame>> outputs;
+
+    // Applies to this frame
+    ResolveKeyframeRequests();
+
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex_);
+        if (!codec_ctx_ || av_frame_make_writable(frame_) < 0 || !ConvertPixelFormat(frame, frame_)) {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.frames_dropped++;
+            return;
+        }
+
+        // The pooled encoders turn AV_PICTURE_TYPE_I into an IDR, every other type is left to the encoder
+        bool keyframe = force_keyframe_.exchange(false);
+        frame_->pict_type = keyframe ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
+        frame_->pts = frame_count_++;
+        auto layer = ApplyTemporalLayer(frame_, frame->timestamp, keyframe);
+
+        int ret = avcodec_send_frame(codec_ctx_, frame_);
+        if (ret < 0) {
+            LOG_ERROR("avcodec_send_frame failed: %d", ret);
+            if (keyframe) {
+                force_keyframe_ = true;
+            }
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.frames_dropped++;
+            return;
+        }
+        pending_frames_.push_back({frame_->pts, frame->timestamp, keyframe, layer});
+        ReceivePackets(outputs);
+    }
+
+    auto encode_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+
+    // Deliver outside the encoder lock so slow sinks never block reconfiguration
+    for (auto &output : outputs) {
+        UpdateStats(output->Size(), encode_time);
+        DeliverFrame(output);
+    }
+}
+
+void VideoEncoder::ReceivePackets(std::vector<std::shared_ptr<Frame>> &outputs)
+{
+    int ret;
+    while ((ret = avcodec_receive_packet(codec_ctx_, packet_)) >= 0) {
+        auto output = ProcessEncodedPacket(packet_);
+        if (output) {
+            outputs.push_back(output);
+        }
+        av_packet_unref(packet_);
+    }
+    if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+        LOG_ERROR("avcodec_receive_packet failed: %d", ret);
+    }
+}
+
+bool VideoEncoder::InitializeFFmpeg()
+{
+    backend_ = VideoCodecBackend::Create(config_.output_format);
+    if (!backend_) {
+        return false;
+    }
+
+    if (config_.use_context_pool) {
+        bool reused = false;
+        codec_ctx_ = EncoderContextPool::GetInstance()->Acquire(config_, &reused).release();
+        if (!codec_ctx_) {
+            return false;
+        }
+        codec_ = codec_ctx_->codec;
+        if (reused) {
+            // The flushed context still holds the previous session's references
+            force_keyframe_ = true;
+        }
+    } else if (!OpenCodecContext()) {
+        CleanupFFmpeg();
+        return false;
+    }
+
+    frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (!frame_ || !packet_) {
+        LOG_ERROR("Failed to allocate encoder frame/packet");
+        CleanupFFmpeg();
+        return false;
+    }
+
+    frame_->format = codec_ctx_->pix_fmt;
+    frame_->width = codec_ctx_->width;
+    frame_->height = codec_ctx_->height;
+    if (av_frame_get_buffer(frame_, 32) < 0) {
+        LOG_ERROR("Failed to allocate encoder picture buffer");
+        CleanupFFmpeg();
+        return false;
+    }
+
+    frame_count_ = 0;
+    if (backend_->SupportsTemporalLayers() && (config_.temporal_layers > 1 || config_.long_term_references)) {
+        temporal_layers_ = std::make_unique<TemporalLayerStructure>(config_.temporal_layers);
+    } else {
+        temporal_layers_.reset();
+    }
+    if (!temporal_layers_ || !config_.long_term_references) {
+        ltr_controller_.reset();
+    } else if (!ltr_controller_) {
+        // Kept across reopening the encoder, so that registered receivers stay; the new
+        // encoder's first keyframe empties the slots
+        ltr_controller_ = std::make_shared<LongTermReferenceController>(temporal_layers_->GetLayerCount(),
+                                                                        config_.ltr_refresh_interval);
+    }
+    LOG_INFO("%s encoder (%s) opened: %ux%u@%u, %u bps, %d threads", backend_->GetName(), codec_->name,
+             config_.width, config_.height, config_.fps, config_.bitrate, codec_ctx_->thread_count);
+    return true;
+}
+
+bool VideoEncoder::OpenCodecContext()
+{
+    codec_ = backend_->FindEncoder();
+    if (!codec_) {
+        LOG_ERROR("No %s encoder available in this FFmpeg build", backend_->GetName());
+        return false;
+    }
+
+    codec_ctx_ = avcodec_alloc_context3(codec_);
+    if (!codec_ctx_) {
+        LOG_ERROR("Failed to allocate %s codec context", backend_->GetName());
+        return false;
+    }
+
+    AVDictionary *options = nullptr;
+    bool configured = backend_->Configure(codec_ctx_, codec_, config_, &options);
+    int ret = configured ? avcodec_open2(codec_ctx_, codec_, &options) : -1;
+    av_dict_free(&options);
+    if (ret < 0) {
+        LOG_ERROR("Failed to open %s encoder (%s) for %ux%u: %d", backend_->GetName(), codec_->name, config_.width,
+                  config_.height, ret);
+        return false;
+    }
+    return true;
+}
+
+void VideoEncoder::CleanupFFmpeg()
+{
+    if (sws_ctx_) {
+        sws_freeContext(sws_ctx_);
+        sws_ctx_ = nullptr;
+    }
+    if (packet_) {
+        av_packet_free(&packet_);
+    }
+    if (frame_) {
+        av_frame_free(&frame_);
+    }
+    if (codec_ctx_ && config_.use_context_pool) {
+        // Packets still inside the encoder are dropped by the pool's flush
+        EncoderContextPool::GetInstance()->Release(config_, EncoderContextPool::ContextPtr(codec_ctx_));
+        codec_ctx_ = nullptr;
+    } else if (codec_ctx_) {
+        avcodec_free_context(&codec_ctx_);
+    }
+    codec_ = nullptr;
+    pending_frames_.clear();
+}
+
+bool VideoEncoder::ConvertPixelFormat(const std::shared_ptr<Frame> &input_frame, AVFrame *av_frame)
+{
+    AVPixelFormat src_format = ToAVPixelFormat(input_frame->format);
+    if (src_format == AV_PIX_FMT_NONE) {
+        LOG_ERROR("Unsupported input format %d", static_cast<int>(input_frame->format));
+        return false;
+    }
+
+    int width = input_frame->width();
+    int height = input_frame->height();
+    uint8_t *src_data[4] = {};
+    int src_linesize[4] = {};
+    int required = av_image_fill_arrays(src_data, src_linesize, input_frame->data(), src_format, width, height, 1);
+    if (required < 0) {
+        LOG_ERROR("Invalid %dx%d input frame", width, height);
+        return false;
+    }
+    if (IsPackedFormat(input_frame->format) && input_frame->stride > static_cast<uint32_t>(src_linesize[0])) {
+        required = static_cast<int>(input_frame->stride) * (height - 1) + src_linesize[0];
+        src_linesize[0] = static_cast<int>(input_frame->stride);
+    }
+    if (input_frame->Size() < static_cast<size_t>(required)) {
+        LOG_ERROR("Frame of %zu bytes is too small for %dx%d format %d", input_frame->Size(), width, height,
+                  static_cast<int>(input_frame->format));
+        return false;
+    }
+
+    const uint8_t *src_planes[4] = {src_data[0], src_data[1], src_data[2], src_data[3]};
+    if (src_format == av_frame->format && width == av_frame->width && height == av_frame->height) {
+        av_image_copy(av_frame->data, av_frame->linesize, src_planes, src_linesize, src_format, width, height);
+        return true;
+    }
+
+    // Colour conversion, and scaling when the frame does not match the configured size
+    sws_ctx_ = sws_getCachedContext(sws_ctx_, width, height, src_format, av_frame->width, av_frame->height,
+                                    static_cast<AVPixelFormat>(av_frame->format), SWS_FAST_BILINEAR, nullptr, nullptr,
+                                    nullptr);
+    if (!sws_ctx_) {
+        LOG_ERROR("Failed to create conversion context from format %d", static_cast<int>(input_frame->format));
+        return false;
+    }
+    sws_scale(sws_ctx_, src_planes, src_linesize, 0, height, av_frame->data, av_frame->linesize);
+    return true;
+}
+
+TemporalLayerStructure::FrameConfig VideoEncoder::ApplyTemporalLayer(AVFrame *av_frame, int64_t timestamp,
+                                                                     bool keyframe)
+{
+    av_dict_free(&av_frame->metadata);
+    if (!temporal_layers_) {
+        return {};
+    }
+
+    if (keyframe) {
+        temporal_layers_->Reset();
+    }
+    auto layer = temporal_layers_->NextFrame();
+    if (ltr_controller_ && ltr_controller_->ApplyToFrame(layer, timestamp, keyframe)) {
+        // The recovery frame starts a new short-term chain, like a keyframe
+        temporal_layers_->Reset();
+        temporal_layers_->NextFrame();
+    }
+    // libvpxenc reads both per frame: reference/update flags and the layer for its rate control
+    av_dict_set_int(&av_frame->metadata, "vp8-flags", layer.vpx_flags, 0);
+    av_dict_set_int(&av_frame->metadata, "temporal_id", layer.temporal_id, 0);
+    return layer;
+}
+
+std::shared_ptr<Frame> VideoEncoder::ProcessEncodedPacket(AVPacket *packet)
+{
+    // Packets come out in input order; inputs the encoder dropped have no packet
+    while (!pending_frames_.empty() && pending_frames_.front().pts < packet->pts) {
+        pending_frames_.pop_front();
+    }
+    PendingFrame input;
+    if (!pending_frames_.empty() && pending_frames_.front().pts == packet->pts) {
+        input = pending_frames_.front();
+        pending_frames_.pop_front();
+    }
+
+    auto output = std::make_shared<Frame>(static_cast<size_t>(packet->size));
+    output->SetSize(packet->size);
+    std::memcpy(output->Data(), packet->data, packet->size);
+    output->format = backend_->GetOutputFormat();
+    output->timestamp = input.timestamp;
+    output->width() = static_cast<uint16_t>(codec_ctx_->width);
+    output->height() = static_cast<uint16_t>(codec_ctx_->height);
+    output->video_info.framerate = config_.fps;
+    output->video_info.is_keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    output->video_info.temporal_id = input.layer.temporal_id;
+    output->video_info.long_term_reference = input.layer.long_term_reference;
+
+    if (output->video_info.is_keyframe && !input.keyframe && temporal_layers_) {
+        // A keyframe the encoder placed itself (keyframe_interval, first frame of a new encoder)
+        // must survive layer dropping, and layers and long-term slots restart from it
+        output->video_info.temporal_id = 0;
+        temporal_layers_->Reset();
+        temporal_layers_->NextFrame();
+        if (ltr_controller_) {
+            ltr_controller_->OnKeyframe(input.timestamp);
+            output->video_info.long_term_reference = true;
+        }
+    }
+    return output;
+}
+
+void VideoEncoder::UpdateStats(size_t encoded_size, std::chrono::milliseconds encode_time)
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+
+    stats_.frames_encoded++;
+    stats_.total_bytes_encoded += encoded_size;
+    window_frames_++;
+    window_bytes_ += encoded_size;
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_stats_time_);
+    if (elapsed.count() >= 1000) {
+        stats_.current_fps = static_cast<uint32_t>(window_frames_ * 1000 / elapsed.count());
+        stats_.current_bitrate = static_cast<uint32_t>(window_bytes_ * 8 * 1000 / elapsed.count());
+        window_frames_ = 0;
+        window_bytes_ = 0;
+        last_stats_time_ = now;
+    }
+
+    // Exponential moving average, same weighting as VideoScaler
+    if (stats_.frames_encoded == 1) {
+        stats_.avg_encode_time = encode_time;
+    } else {
+        auto new_avg = stats_.avg_encode_time.count() * 0.9 + encode_time.count() * 0.1;
+        stats_.avg_encode_time = std::chrono::milliseconds(static_cast<long long>(new_avg));
+    }
+}
+
+} // namespace lmshao::remotedesk
@@ -10,12 +10,21 @@
 #define LMSHAO_REMOTE_DESK_VIDEO_ENCODER_H
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "../core/media_processor.h"
+#include "keyframe_arbiter.h"
+#include "long_term_reference_controller.h"
+#include "temporal_layer_structure.h"
+#include "video_codec_backend.h"
 
 // FFmpeg headers
 extern "C" {
@@ -37,11 +46,25 @@ struct VideoEncoderConfig {
     uint32_t bitrate = 2000000;      // 2Mbps
     uint32_t keyframe_interval = 30; // Keyframe every 30 frames
     FrameFormat input_format = FrameFormat::BGRA32;
-    FrameFormat output_format = FrameFormat::H264;
+    FrameFormat output_format = FrameFormat::H264; // H264, H265, VP8 or VP9
+    EncoderSpeedPreset speed_preset = EncoderSpeedPreset::ULTRA_FAST;
+    bool screen_content = true; // Tune for text-heavy desktop content where the codec supports it
+    uint32_t thread_count = 0;  // Encoder worker threads (0 = auto-detect)
+    bool use_context_pool = true; // Check codec contexts out of EncoderContextPool instead of reopening
+    uint8_t temporal_layers = 1;  // Temporal scalability: 1 = L1T1, 2 = L1T2, 3 = L1T3 (VP8/VP9 only)
+    bool long_term_references = false; // Recover from loss via acknowledged long-term references (VP8/VP9 only)
+    uint32_t ltr_refresh_interval = 30; // Base layer frames between long-term reference refreshes
+    bool intra_refresh = false;         // H264: heal losses with an intra refresh wave instead of an IDR
+    bool full_chroma = false;           // H264 High 4:4:4: no chroma subsampling fringes on thin coloured lines
+    bool lossless = false;              // H264 qp=0 in High 4:4:4 (implies full_chroma), bitrate is ignored
+    uint8_t bit_depth = 8;              // 10: H265 Main10 (libx265), fed with I010 or X2RGB10 frames
+    bool use_encode_thread = true;      // false: encode inside OnFrame, e.g. when run by a SessionWorkerPool
+    KeyframeArbiterConfig keyframe_arbiter; // Coalescing of RequestKeyFrame() calls, read at construction
 };
 
 /**
- * @brief Video encoder - encodes raw video frames to H264
+ * @brief Video encoder - encodes raw video frames to H264/H265/VP8/VP9
+ * Codec specific setup is delegated to a VideoCodecBackend chosen from output_format
  * Inherits from MediaProcessor as a processing node in Pipeline
  */
 class VideoEncoder : public MediaProcessor {
@@ -54,7 +77,7 @@ public:
     bool Start() override;
     void Stop() override;
     bool IsRunning() const override;
-    void OnFrame(std::shared_ptr<Frame> frame) override;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
 
     /**
      * @brief Update configuration (dynamic adjustment)
@@ -76,6 +99,41 @@ public:
      */
     void ForceKeyFrame();
 
+    /**
+     * @brief A receiver asked for a keyframe (PLI, FIR, new receiver)
+     * Requests of all receivers are merged by a KeyframeArbiter and answered on a
+     * later frame with the cheapest recovery that serves all of them: a long-term
+     * reference, an intra refresh wave or a keyframe.
+     */
+    void RequestKeyFrame(const std::string &receiver_id, KeyframeRequestReason reason = KeyframeRequestReason::LOSS);
+
+    /**
+     * @brief Recover receivers from packet loss
+     * Predicts the next frame from the newest long-term reference acknowledged
+     * by every receiver, and falls back to ForceKeyFrame() when there is none
+     * or long_term_references is off.
+     * @return true if a long-term reference is used instead of a keyframe
+     */
+    bool RequestRecovery();
+
+    /**
+     * @brief Start an intra refresh wave over the next keyframe_interval frames
+     * Needs intra_refresh and a backend that supports it, falls back to ForceKeyFrame().
+     * @return true if a wave was started instead of a keyframe
+     */
+    bool StartIntraRefresh();
+
+    /**
+     * @brief Whether StartIntraRefresh() can avoid a keyframe with the current configuration
+     */
+    bool SupportsIntraRefresh() const { return config_.intra_refresh && backend_ && backend_->SupportsIntraRefresh(); }
+
+    /**
+     * @brief Long-term reference bookkeeping (receivers and acknowledgements)
+     * @return nullptr unless long_term_references is on and the backend supports it
+     */
+    std::shared_ptr<LongTermReferenceController> GetLongTermReferenceController() const { return ltr_controller_; }
+
     /**
      * @brief Flush encoder buffer
      */
@@ -103,41 +161,91 @@ private:
 
     /**
      * @brief Initialize FFmpeg encoder
+     * A context reused from EncoderContextPool sets force_keyframe_, so that the first
+     * frame is sent as AV_PICTURE_TYPE_I and does not reference the previous session
      */
     bool InitializeFFmpeg();
 
+    /**
+     * @brief Allocate, configure and open a codec context without the pool
+     */
+    bool OpenCodecContext();
+
     /**
      * @brief Cleanup FFmpeg resources
+     * With use_context_pool the codec context is flushed and returned to EncoderContextPool
      */
     void CleanupFFmpeg();
 
+    /**
+     * @brief Apply the arbiter's decision once the pending batch of keyframe requests is due
+     */
+    void ResolveKeyframeRequests();
+
+    /**
+     * @brief Encode one frame and deliver the packets it produced
+     * Runs on the encoding thread, or inside OnFrame without use_encode_thread
+     */
+    void EncodeFrame(const std::shared_ptr<Frame> &frame);
+
+    /**
+     * @brief Collect the packets the encoder has ready (encode_mutex_ held)
+     */
+    void ReceivePackets(std::vector<std::shared_ptr<Frame>> &outputs);
+
     /**
      * @brief Convert pixel format
      */
-    bool ConvertPixelFormat(std::shared_ptr<Frame> input_frame, AVFrame *av_frame);
+    bool ConvertPixelFormat(const std::shared_ptr<Frame> &input_frame, AVFrame *av_frame);
+
+    /**
+     * @brief Attach the next temporal layer and long-term reference decision to the frame
+     * The decision is kept in pending_frames_ and assigned to the matching output packet
+     * (the encoder has no lookahead, so packets come out in input order).
+     */
+    TemporalLayerStructure::FrameConfig ApplyTemporalLayer(AVFrame *av_frame, int64_t timestamp, bool keyframe);
 
     /**
-     * @brief Process encoded packet
+     * @brief Wrap an encoded packet into an output frame (encode_mutex_ held)
      */
-    void ProcessEncodedPacket(AVPacket *packet);
+    std::shared_ptr<Frame> ProcessEncodedPacket(AVPacket *packet);
 
     /**
      * @brief Update statistics
      */
-    void UpdateStats(size_t encoded_size);
+    void UpdateStats(size_t encoded_size, std::chrono::milliseconds encode_time);
 
 private:
     VideoEncoderConfig config_;
     std::atomic<bool> running_{false};
+    std::atomic<bool> threaded_{false}; // use_encode_thread as of Start()
     std::atomic<bool> force_keyframe_{false};
 
+    // Keyframe requests of all receivers
+    KeyframeArbiter keyframe_arbiter_;
+    std::atomic<int64_t> keyframe_resolve_at_{0}; // steady_clock ticks, 0 = no batch pending
+
     // FFmpeg related
+    std::unique_ptr<VideoCodecBackend> backend_;
     const AVCodec *codec_ = nullptr;
     AVCodecContext *codec_ctx_ = nullptr;
     AVFrame *frame_ = nullptr;
     AVPacket *packet_ = nullptr;
     SwsContext *sws_ctx_ = nullptr;
 
+    // Temporal scalability and long-term references
+    std::unique_ptr<TemporalLayerStructure> temporal_layers_;
+    std::shared_ptr<LongTermReferenceController> ltr_controller_;
+
+    // Input frames sent to the encoder whose packet did not come out yet
+    struct PendingFrame {
+        int64_t pts = 0;
+        int64_t timestamp = 0;
+        bool keyframe = false; // Sent as AV_PICTURE_TYPE_I
+        TemporalLayerStructure::FrameConfig layer;
+    };
+    std::deque<PendingFrame> pending_frames_;
+
     // Encoding queue
     std::queue<std::shared_ptr<Frame>> encode_queue_;
     std::mutex queue_mutex_;
@@ -153,9 +261,11 @@ private:
     mutable std::mutex stats_mutex_;
     EncodeStats stats_;
     std::chrono::steady_clock::time_point last_stats_time_;
+    uint32_t window_frames_ = 0; // Frames and bytes since last_stats_time_, for current_fps/current_bitrate
+    uint64_t window_bytes_ = 0;
 
     // Frame count
-    uint64_t frame_count_ = 0;
+    int64_t frame_count_ = 0;
 };
 
 } // namespace lmshao::remotedesk
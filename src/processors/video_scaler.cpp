@@ -11,11 +11,19 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 #include "../log/remote_desk_log.h"
 
 namespace lmshao::remotedesk {
 
+namespace {
+
+// Source pixels on each side that one output sample reads (bilinear reads the next pixel)
+constexpr int32_t SCALING_FILTER_RADIUS = 1;
+
+} // namespace
+
 VideoScaler::VideoScaler(const VideoScalerConfig &config) : config_(config)
 {
     last_stats_time_ = std::chrono::steady_clock::now();
@@ -74,7 +82,15 @@ bool VideoScaler::Initialize()
     return true;
 }
 
-void VideoScaler::OnFrame(std::shared_ptr<Frame> frame)
+void VideoScaler::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    auto output_frame = Process(frame);
+    if (output_frame) {
+        DeliverFrame(output_frame);
+    }
+}
+
+std::shared_ptr<Frame> VideoScaler::Process(const std::shared_ptr<Frame> &frame)
 {
     if (!frame || !frame->IsValid() || !frame->IsVideo()) {
         LOG_WARN("Received invalid frame: frame=%p, valid=%s, video=%s", frame.get(),
@@ -82,7 +98,7 @@ void VideoScaler::OnFrame(std::shared_ptr<Frame> frame)
                  frame ? (frame->IsVideo() ? "true" : "false") : "N/A");
         std::lock_guard<std::mutex> stats_lock(stats_mutex_);
         stats_.frames_dropped++;
-        return;
+        return nullptr;
     }
 
     auto start_time = std::chrono::steady_clock::now();
@@ -91,9 +107,9 @@ void VideoScaler::OnFrame(std::shared_ptr<Frame> frame)
     if (!IsScalingNeeded(frame->width(), frame->height())) {
         LOG_DEBUG("No scaling needed for frame %ux%u (matches target), forwarding directly", frame->width(),
                   frame->height());
-        // Forward frame without scaling
-        DeliverFrame(frame);
-        return;
+        // Forward frame without scaling, the canvas misses this frame's changes
+        canvas_.reset();
+        return frame;
     }
 
     // Scale the frame
@@ -109,16 +125,18 @@ void VideoScaler::OnFrame(std::shared_ptr<Frame> frame)
                   scaled_frame->width(), scaled_frame->height(), processing_time.count());
         UpdateStats(frame->width(), frame->height(), scaled_frame->width(), scaled_frame->height(), processing_time);
         // Forward scaled frame
-        DeliverFrame(scaled_frame);
-    } else {
-        LOG_ERROR("Failed to scale frame from %ux%u to %ux%u", frame->width(), frame->height(), config_.target_width,
-                  config_.target_height);
-        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
-        stats_.frames_dropped++;
+        return scaled_frame;
     }
+
+    LOG_ERROR("Failed to scale frame from %ux%u to %ux%u", frame->width(), frame->height(), config_.target_width,
+              config_.target_height);
+    canvas_.reset();
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    stats_.frames_dropped++;
+    return nullptr;
 }
 
-std::shared_ptr<Frame> VideoScaler::ScaleFrame(std::shared_ptr<Frame> input_frame)
+std::shared_ptr<Frame> VideoScaler::ScaleFrame(const std::shared_ptr<Frame> &input_frame)
 {
     if (!input_frame || !input_frame->IsValid()) {
         LOG_ERROR("ScaleFrame: Invalid input frame");
@@ -131,15 +149,6 @@ std::shared_ptr<Frame> VideoScaler::ScaleFrame(std::shared_ptr<Frame> input_fram
     LOG_DEBUG("ScaleFrame: Input %ux%u -> Target %ux%u, format=%d", input_frame->width(), input_frame->height(),
               target_width, target_height, static_cast<int>(input_frame->format));
 
-    // Create output frame
-    auto output_frame = std::make_shared<Frame>();
-    output_frame->format = input_frame->format;
-    output_frame->timestamp = input_frame->timestamp;
-    output_frame->width() = target_width;
-    output_frame->height() = target_height;
-    output_frame->video_info.framerate = input_frame->video_info.framerate;
-    output_frame->video_info.is_keyframe = input_frame->video_info.is_keyframe;
-
     // Calculate bytes per pixel based on format
     uint32_t bytes_per_pixel = 4; // Default for BGRA32/RGBA32
     switch (input_frame->format) {
@@ -149,6 +158,7 @@ std::shared_ptr<Frame> VideoScaler::ScaleFrame(std::shared_ptr<Frame> input_fram
             break;
         case FrameFormat::RGBA32:
         case FrameFormat::BGRA32:
+        case FrameFormat::X2RGB10:
             bytes_per_pixel = 4;
             break;
         case FrameFormat::I420:
@@ -160,24 +170,61 @@ std::shared_ptr<Frame> VideoScaler::ScaleFrame(std::shared_ptr<Frame> input_fram
             break;
     }
 
+    if (input_frame->format != FrameFormat::BGRA32 && input_frame->format != FrameFormat::RGBA32 &&
+        input_frame->format != FrameFormat::X2RGB10) {
+        LOG_ERROR("ScaleFrame: Unsupported pixel format %d for scaling", static_cast<int>(input_frame->format));
+        // For other formats, implement specific scaling or use fallback
+        return nullptr;
+    }
+
+    // Rectangles describe the change from the previous frame, which the canvas must hold
+    bool incremental = config_.incremental && !input_frame->dirty_rects.empty() && canvas_ &&
+                       canvas_->format == input_frame->format && canvas_->width() == target_width &&
+                       canvas_->height() == target_height && canvas_source_width_ == input_frame->width() &&
+                       canvas_source_height_ == input_frame->height();
+
     // Calculate output frame size
     size_t output_size = target_width * target_height * bytes_per_pixel;
     LOG_DEBUG("ScaleFrame: Allocating output frame: %ux%u, %u bytes_per_pixel, total size: %zu bytes", target_width,
               target_height, bytes_per_pixel, output_size);
-    output_frame->SetCapacity(output_size);
-    output_frame->SetSize(output_size);
+    auto output_frame = AcquireCanvas(canvas_, output_size, incremental);
+    bool copied = incremental && output_frame != canvas_; // Still held downstream
+    output_frame->format = input_frame->format;
+    output_frame->timestamp = input_frame->timestamp;
+    output_frame->width() = target_width;
+    output_frame->height() = target_height;
+    output_frame->video_info.framerate = input_frame->video_info.framerate;
+    output_frame->video_info.is_keyframe = input_frame->video_info.is_keyframe;
     output_frame->stride = target_width * bytes_per_pixel;
+    output_frame->dirty_rects.clear();
 
     // Perform simple bilinear scaling (software implementation)
     // Note: In production, you might want to use libswscale or hardware acceleration
-    if (input_frame->format == FrameFormat::BGRA32 || input_frame->format == FrameFormat::RGBA32) {
-        LOG_DEBUG("ScaleFrame: Performing bilinear scaling for format %s",
-                  input_frame->format == FrameFormat::BGRA32 ? "BGRA32" : "RGBA32");
-        PerformBilinearScaling(input_frame, output_frame);
+    LOG_DEBUG("ScaleFrame: Performing %s bilinear scaling for format %d", incremental ? "incremental" : "full",
+              static_cast<int>(input_frame->format));
+    if (incremental) {
+        for (const auto &dirty : input_frame->dirty_rects) {
+            FrameRect dst_rect = MapDirtyRect(dirty, input_frame->width(), input_frame->height(), target_width,
+                                              target_height);
+            if (!dst_rect.IsEmpty()) {
+                PerformBilinearScaling(input_frame, output_frame, dst_rect);
+                output_frame->dirty_rects.push_back(dst_rect);
+            }
+        }
     } else {
-        LOG_ERROR("ScaleFrame: Unsupported pixel format %d for scaling", static_cast<int>(input_frame->format));
-        // For other formats, implement specific scaling or use fallback
-        return nullptr;
+        FrameRect dst_rect;
+        dst_rect.width = static_cast<uint16_t>(target_width);
+        dst_rect.height = static_cast<uint16_t>(target_height);
+        PerformBilinearScaling(input_frame, output_frame, dst_rect);
+    }
+
+    canvas_ = output_frame;
+    canvas_source_width_ = input_frame->width();
+    canvas_source_height_ = input_frame->height();
+    if (incremental) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_incremental++;
+        stats_.canvas_copies += copied ? 1 : 0;
     }
 
     LOG_DEBUG("ScaleFrame: Successfully scaled frame from %ux%u to %ux%u", input_frame->width(), input_frame->height(),
@@ -186,8 +233,14 @@ std::shared_ptr<Frame> VideoScaler::ScaleFrame(std::shared_ptr<Frame> input_fram
     return output_frame;
 }
 
-void VideoScaler::PerformBilinearScaling(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output)
+void VideoScaler::PerformBilinearScaling(const std::shared_ptr<Frame> &input, const std::shared_ptr<Frame> &output,
+                                         const FrameRect &dst_rect)
 {
+    if (input->format == FrameFormat::X2RGB10) {
+        PerformBilinearScaling10(input, output, dst_rect);
+        return;
+    }
+
     const uint8_t *src = input->data();
     uint8_t *dst = output->data();
 
@@ -199,8 +252,10 @@ void VideoScaler::PerformBilinearScaling(std::shared_ptr<Frame> input, std::shar
     float x_ratio = static_cast<float>(src_width) / dst_width;
     float y_ratio = static_cast<float>(src_height) / dst_height;
 
-    for (uint32_t y = 0; y < dst_height; ++y) {
-        for (uint32_t x = 0; x < dst_width; ++x) {
+    const uint32_t x_end = std::min<uint32_t>(dst_rect.x + dst_rect.width, dst_width);
+    const uint32_t y_end = std::min<uint32_t>(dst_rect.y + dst_rect.height, dst_height);
+    for (uint32_t y = dst_rect.y; y < y_end; ++y) {
+        for (uint32_t x = dst_rect.x; x < x_end; ++x) {
             // Calculate source coordinates
             float src_x = x * x_ratio;
             float src_y = y * y_ratio;
@@ -240,6 +295,93 @@ void VideoScaler::PerformBilinearScaling(std::shared_ptr<Frame> input, std::shar
     }
 }
 
+void VideoScaler::PerformBilinearScaling10(const std::shared_ptr<Frame> &input, const std::shared_ptr<Frame> &output,
+                                           const FrameRect &dst_rect)
+{
+    const uint8_t *src = input->data();
+    uint8_t *dst = output->data();
+
+    uint32_t src_width = input->width();
+    uint32_t src_height = input->height();
+    uint32_t dst_width = output->width();
+    uint32_t dst_height = output->height();
+
+    float x_ratio = static_cast<float>(src_width) / dst_width;
+    float y_ratio = static_cast<float>(src_height) / dst_height;
+
+    auto load = [src](size_t index) {
+        uint32_t pixel;
+        std::memcpy(&pixel, src + index * 4, sizeof(pixel));
+        return pixel;
+    };
+
+    const uint32_t x_end = std::min<uint32_t>(dst_rect.x + dst_rect.width, dst_width);
+    const uint32_t y_end = std::min<uint32_t>(dst_rect.y + dst_rect.height, dst_height);
+    for (uint32_t y = dst_rect.y; y < y_end; ++y) {
+        for (uint32_t x = dst_rect.x; x < x_end; ++x) {
+            // Same sampling positions as the 8-bit path
+            float src_x = x * x_ratio;
+            float src_y = y * y_ratio;
+            uint32_t x1 = static_cast<uint32_t>(src_x);
+            uint32_t y1 = static_cast<uint32_t>(src_y);
+            uint32_t x2 = std::min(x1 + 1, src_width - 1);
+            uint32_t y2 = std::min(y1 + 1, src_height - 1);
+            float dx = src_x - x1;
+            float dy = src_y - y1;
+
+            uint32_t tl = load(y1 * src_width + x1);
+            uint32_t tr = load(y1 * src_width + x2);
+            uint32_t bl = load(y2 * src_width + x1);
+            uint32_t br = load(y2 * src_width + x2);
+
+            // Interpolate each 10-bit field, the two padding bits come from the top-left pixel
+            uint32_t result = tl & 0xC0000000u;
+            for (int shift = 0; shift <= 20; shift += 10) {
+                float c_tl = static_cast<float>((tl >> shift) & 0x3FF);
+                float c_tr = static_cast<float>((tr >> shift) & 0x3FF);
+                float c_bl = static_cast<float>((bl >> shift) & 0x3FF);
+                float c_br = static_cast<float>((br >> shift) & 0x3FF);
+
+                float top = c_tl + dx * (c_tr - c_tl);
+                float bottom = c_bl + dx * (c_br - c_bl);
+                float value = std::clamp(top + dy * (bottom - top), 0.0f, 1023.0f);
+                result |= static_cast<uint32_t>(value) << shift;
+            }
+            std::memcpy(dst + (static_cast<size_t>(y) * dst_width + x) * 4, &result, sizeof(result));
+        }
+    }
+}
+
+FrameRect VideoScaler::MapDirtyRect(const FrameRect &src_rect, uint32_t src_width, uint32_t src_height,
+                                    uint32_t dst_width, uint32_t dst_height) const
+{
+    // Output sample x reads source columns floor(x * ratio) and the next one
+    float x_ratio = static_cast<float>(src_width) / dst_width;
+    float y_ratio = static_cast<float>(src_height) / dst_height;
+
+    // One extra output pixel on the leading edge absorbs float rounding in the kernel
+    int32_t left = static_cast<int32_t>(std::floor((src_rect.x - SCALING_FILTER_RADIUS) / x_ratio)) - 1;
+    int32_t top = static_cast<int32_t>(std::floor((src_rect.y - SCALING_FILTER_RADIUS) / y_ratio)) - 1;
+    int32_t right =
+        static_cast<int32_t>(std::ceil((src_rect.x + src_rect.width + SCALING_FILTER_RADIUS) / x_ratio)) + 1;
+    int32_t bottom =
+        static_cast<int32_t>(std::ceil((src_rect.y + src_rect.height + SCALING_FILTER_RADIUS) / y_ratio)) + 1;
+
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, static_cast<int32_t>(dst_width));
+    bottom = std::min(bottom, static_cast<int32_t>(dst_height));
+
+    FrameRect dst_rect;
+    if (left < right && top < bottom) {
+        dst_rect.x = static_cast<uint16_t>(left);
+        dst_rect.y = static_cast<uint16_t>(top);
+        dst_rect.width = static_cast<uint16_t>(right - left);
+        dst_rect.height = static_cast<uint16_t>(bottom - top);
+    }
+    return dst_rect;
+}
+
 std::pair<uint32_t, uint32_t> VideoScaler::CalculateTargetDimensions(uint32_t input_width, uint32_t input_height) const
 {
     if (!config_.maintain_aspect_ratio) {
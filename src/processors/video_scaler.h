@@ -35,6 +35,9 @@ struct VideoScalerConfig {
     ScalingAlgorithm algorithm = ScalingAlgorithm::BILINEAR;
     bool maintain_aspect_ratio = true;
     bool enable_threading = true;
+
+    // Keep the output as a persistent canvas and rescale only the area under the frame's dirty_rects
+    bool incremental = true;
 };
 
 /**
@@ -56,7 +59,14 @@ public:
 
     // MediaProcessor interface implementation
     bool Initialize() override;
-    void OnFrame(std::shared_ptr<Frame> frame) override;
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+    void OnFramesDropped() override { canvas_.reset(); } // Next frame is scaled whole
+
+    /**
+     * @brief Scale one frame without delivering it (used by StaticPipeline)
+     * @return The scaled frame, the input itself if it already has the target size, or nullptr
+     */
+    std::shared_ptr<Frame> Process(const std::shared_ptr<Frame> &frame);
 
     /**
      * @brief Get scaling statistics
@@ -69,6 +79,8 @@ public:
         uint32_t input_height = 0;
         uint32_t output_width = 0;
         uint32_t output_height = 0;
+        uint64_t frames_incremental = 0; // Rescaled from dirty rectangles only
+        uint64_t canvas_copies = 0;      // Canvas still held downstream, copied before the update
     };
     ScalingStats GetStats() const;
 
@@ -76,7 +88,7 @@ private:
     /**
      * @brief Scale frame using software scaling
      */
-    std::shared_ptr<Frame> ScaleFrame(std::shared_ptr<Frame> input_frame);
+    std::shared_ptr<Frame> ScaleFrame(const std::shared_ptr<Frame> &input_frame);
 
     /**
      * @brief Calculate target dimensions maintaining aspect ratio
@@ -96,13 +108,33 @@ private:
 
     /**
      * @brief Perform bilinear scaling for BGRA/RGBA formats
+     * @param dst_rect Output area to compute, the rest of the output keeps its content
      */
-    void PerformBilinearScaling(std::shared_ptr<Frame> input, std::shared_ptr<Frame> output);
+    void PerformBilinearScaling(const std::shared_ptr<Frame> &input, const std::shared_ptr<Frame> &output,
+                                const FrameRect &dst_rect);
+
+    /**
+     * @brief Perform bilinear scaling for X2RGB10, each 10-bit channel interpolated on its own
+     */
+    void PerformBilinearScaling10(const std::shared_ptr<Frame> &input, const std::shared_ptr<Frame> &output,
+                                  const FrameRect &dst_rect);
+
+    /**
+     * @brief Output area whose samples read from a changed input rectangle
+     * The rectangle is grown by the filter support radius before it is mapped.
+     */
+    FrameRect MapDirtyRect(const FrameRect &src_rect, uint32_t src_width, uint32_t src_height, uint32_t dst_width,
+                           uint32_t dst_height) const;
 
 private:
     VideoScalerConfig config_;
     mutable std::mutex mutex_;
 
+    // Last published output and the input size it was scaled from, only touched by the processing thread
+    std::shared_ptr<Frame> canvas_;
+    uint32_t canvas_source_width_ = 0;
+    uint32_t canvas_source_height_ = 0;
+
     // Statistics
     mutable std::mutex stats_mutex_;
     ScalingStats stats_;
@@ -0,0 +1,366 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "yuv_rgb_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+/**
+ * Fixed point layout shared by the scalar and SIMD paths so that they produce
+ * identical output: samples are scaled to Q6, gains are Q13, and the
+ * product is taken with pmulhrsw rounding ((a * b + 2^14) >> 15), giving Q4.
+ */
+struct YuvCoefficients {
+    int16_t y_offset;
+    int16_t y_gain;
+    int16_t r_v;
+    int16_t g_u;
+    int16_t g_v;
+    int16_t b_u;
+};
+
+constexpr int16_t ToQ13(double value)
+{
+    return static_cast<int16_t>(value * 8192.0 + 0.5);
+}
+
+constexpr YuvCoefficients MakeCoefficients(double kr, double kb, bool full_range)
+{
+    double kg = 1.0 - kr - kb;
+    double y_scale = full_range ? 1.0 : 255.0 / 219.0;
+    double c_scale = full_range ? 1.0 : 255.0 / 224.0;
+    return {static_cast<int16_t>(full_range ? 0 : 16),
+            ToQ13(y_scale),
+            ToQ13(2.0 * (1.0 - kr) * c_scale),
+            ToQ13(2.0 * (1.0 - kb) * kb / kg * c_scale),
+            ToQ13(2.0 * (1.0 - kr) * kr / kg * c_scale),
+            ToQ13(2.0 * (1.0 - kb) * c_scale)};
+}
+
+constexpr YuvCoefficients COEFFICIENTS[3][2] = {
+    {MakeCoefficients(0.299, 0.114, false), MakeCoefficients(0.299, 0.114, true)},
+    {MakeCoefficients(0.2126, 0.0722, false), MakeCoefficients(0.2126, 0.0722, true)},
+    {MakeCoefficients(0.2627, 0.0593, false), MakeCoefficients(0.2627, 0.0593, true)},
+};
+
+inline int MulHrs(int a, int b)
+{
+    return (a * b + (1 << 14)) >> 15;
+}
+
+inline uint8_t ClampQ4(int value)
+{
+    return static_cast<uint8_t>(std::clamp((value + 8) >> 4, 0, 255));
+}
+
+template <FrameFormat Dst>
+struct YuvRowKernel {
+    using D = PackedRgbTraits<Dst>;
+    static constexpr int DBPP = D::BYTES_PER_PIXEL;
+    static_assert(D::ALPHA < 0 || D::ALPHA == 3, "SIMD interleave expects alpha in the last byte");
+
+    // half_chroma: u/v hold one sample per two pixels, otherwise one per pixel
+    template <bool HalfChroma>
+    static void Scalar(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, uint32_t begin,
+                       uint32_t end, const YuvCoefficients &k)
+    {
+        for (uint32_t x = begin; x < end; ++x) {
+            uint32_t c = HalfChroma ? x / 2 : x;
+            int yy = MulHrs((y[x] - k.y_offset) << 6, k.y_gain);
+            int uu = (u[c] - 128) << 6;
+            int vv = (v[c] - 128) << 6;
+
+            uint8_t *d = dst + static_cast<size_t>(x) * DBPP;
+            d[D::RED] = ClampQ4(yy + MulHrs(vv, k.r_v));
+            d[D::GREEN] = ClampQ4(yy - MulHrs(uu, k.g_u) - MulHrs(vv, k.g_v));
+            d[D::BLUE] = ClampQ4(yy + MulHrs(uu, k.b_u));
+            if constexpr (D::ALPHA >= 0) {
+                d[D::ALPHA] = 255;
+            }
+        }
+    }
+
+#ifdef REMOTE_DESK_X86_SIMD
+    // Interleave 8 pixels held in the low 8 bytes of r, g and b; 24-bit output writes 4 bytes of slack
+    REMOTE_DESK_TARGET_SSSE3 static inline void Store8(__m128i r, __m128i g, __m128i b, uint8_t *dst)
+    {
+        __m128i channels[4];
+        channels[D::RED] = r;
+        channels[D::GREEN] = g;
+        channels[D::BLUE] = b;
+        channels[3] = _mm_set1_epi8(-1);
+
+        __m128i c01 = _mm_unpacklo_epi8(channels[0], channels[1]);
+        __m128i c23 = _mm_unpacklo_epi8(channels[2], channels[3]);
+        __m128i p0 = _mm_unpacklo_epi16(c01, c23);
+        __m128i p1 = _mm_unpackhi_epi16(c01, c23);
+
+        if constexpr (DBPP == 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), p0);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), p1);
+        } else {
+            const __m128i drop_alpha = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(p0, drop_alpha));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), _mm_shuffle_epi8(p1, drop_alpha));
+        }
+    }
+
+    template <bool HalfChroma>
+    REMOTE_DESK_TARGET_SSSE3 static uint32_t Ssse3(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                                                   uint8_t *dst, uint32_t width, const YuvCoefficients &k)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i y_offset = _mm_set1_epi16(k.y_offset);
+        const __m128i y_gain = _mm_set1_epi16(k.y_gain);
+        const __m128i r_v = _mm_set1_epi16(k.r_v);
+        const __m128i g_u = _mm_set1_epi16(k.g_u);
+        const __m128i g_v = _mm_set1_epi16(k.g_v);
+        const __m128i b_u = _mm_set1_epi16(k.b_u);
+        const __m128i bias = _mm_set1_epi16(128);
+        const __m128i round = _mm_set1_epi16(8);
+
+        const size_t slack = DBPP == 3 ? 4 : 0;
+        uint32_t x = 0;
+        for (; x + 8 <= width && (x + 8) * DBPP + slack <= static_cast<size_t>(width) * DBPP; x += 8) {
+            __m128i y8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x));
+            __m128i u8;
+            __m128i v8;
+            if constexpr (HalfChroma) {
+                uint32_t u4;
+                uint32_t v4;
+                memcpy(&u4, u + x / 2, sizeof(u4));
+                memcpy(&v4, v + x / 2, sizeof(v4));
+                u8 = _mm_cvtsi32_si128(static_cast<int>(u4));
+                v8 = _mm_cvtsi32_si128(static_cast<int>(v4));
+                u8 = _mm_unpacklo_epi8(u8, u8);
+                v8 = _mm_unpacklo_epi8(v8, v8);
+            } else {
+                u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x));
+                v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x));
+            }
+
+            __m128i yy = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(y8, zero), y_offset), 6);
+            __m128i uu = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(u8, zero), bias), 6);
+            __m128i vv = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(v8, zero), bias), 6);
+            yy = _mm_add_epi16(_mm_mulhrs_epi16(yy, y_gain), round);
+
+            __m128i r = _mm_srai_epi16(_mm_add_epi16(yy, _mm_mulhrs_epi16(vv, r_v)), 4);
+            __m128i g = _mm_srai_epi16(
+                _mm_sub_epi16(_mm_sub_epi16(yy, _mm_mulhrs_epi16(uu, g_u)), _mm_mulhrs_epi16(vv, g_v)), 4);
+            __m128i b = _mm_srai_epi16(_mm_add_epi16(yy, _mm_mulhrs_epi16(uu, b_u)), 4);
+
+            Store8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g), _mm_packus_epi16(b, b),
+                   dst + static_cast<size_t>(x) * DBPP);
+        }
+        return x;
+    }
+
+    template <bool HalfChroma>
+    REMOTE_DESK_TARGET_AVX2 static uint32_t Avx2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst,
+                                                 uint32_t width, const YuvCoefficients &k)
+    {
+        const __m256i y_offset = _mm256_set1_epi16(k.y_offset);
+        const __m256i y_gain = _mm256_set1_epi16(k.y_gain);
+        const __m256i r_v = _mm256_set1_epi16(k.r_v);
+        const __m256i g_u = _mm256_set1_epi16(k.g_u);
+        const __m256i g_v = _mm256_set1_epi16(k.g_v);
+        const __m256i b_u = _mm256_set1_epi16(k.b_u);
+        const __m256i bias = _mm256_set1_epi16(128);
+        const __m256i round = _mm256_set1_epi16(8);
+
+        const size_t slack = DBPP == 3 ? 4 : 0;
+        uint32_t x = 0;
+        for (; x + 16 <= width && (x + 16) * DBPP + slack <= static_cast<size_t>(width) * DBPP; x += 16) {
+            __m128i y16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x));
+            __m128i u16;
+            __m128i v16;
+            if constexpr (HalfChroma) {
+                u16 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x / 2));
+                v16 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x / 2));
+                u16 = _mm_unpacklo_epi8(u16, u16);
+                v16 = _mm_unpacklo_epi8(v16, v16);
+            } else {
+                u16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x));
+                v16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x));
+            }
+
+            __m256i yy = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(y16), y_offset), 6);
+            __m256i uu = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(u16), bias), 6);
+            __m256i vv = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(v16), bias), 6);
+            yy = _mm256_add_epi16(_mm256_mulhrs_epi16(yy, y_gain), round);
+
+            __m256i r = _mm256_srai_epi16(_mm256_add_epi16(yy, _mm256_mulhrs_epi16(vv, r_v)), 4);
+            __m256i g = _mm256_srai_epi16(
+                _mm256_sub_epi16(_mm256_sub_epi16(yy, _mm256_mulhrs_epi16(uu, g_u)), _mm256_mulhrs_epi16(vv, g_v)),
+                4);
+            __m256i b = _mm256_srai_epi16(_mm256_add_epi16(yy, _mm256_mulhrs_epi16(uu, b_u)), 4);
+
+            // Pack across the two lanes so that bytes come out in pixel order
+            __m128i r8 = _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+            __m128i g8 = _mm_packus_epi16(_mm256_castsi256_si128(g), _mm256_extracti128_si256(g, 1));
+            __m128i b8 = _mm_packus_epi16(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+
+            uint8_t *out = dst + static_cast<size_t>(x) * DBPP;
+            Store8(r8, g8, b8, out);
+            Store8(_mm_srli_si128(r8, 8), _mm_srli_si128(g8, 8), _mm_srli_si128(b8, 8), out + 8 * DBPP);
+        }
+        return x;
+    }
+#endif
+
+    template <bool HalfChroma>
+    static void Run(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, uint32_t width,
+                    const YuvCoefficients &k)
+    {
+        uint32_t done = 0;
+#ifdef REMOTE_DESK_X86_SIMD
+        switch (GetSimdLevel()) {
+            case SimdLevel::AVX512: // Row kernels stay at 256 bits
+            case SimdLevel::AVX2:
+                done = Avx2<HalfChroma>(y, u, v, dst, width, k);
+                break;
+            case SimdLevel::SSSE3:
+                done = Ssse3<HalfChroma>(y, u, v, dst, width, k);
+                break;
+            default:
+                break;
+        }
+#endif
+        Scalar<HalfChroma>(y, u, v, dst, done, width, k);
+    }
+};
+
+/**
+ * Walks the image row by row and hands each row with its chroma to the row kernel.
+ * NV12 chroma is deinterleaved and bilinear chroma is interpolated into
+ * per-row scratch buffers; I420 with nearest upsampling reads the planes directly.
+ */
+template <FrameFormat Dst>
+void ConvertRows(FrameFormat src_format, const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height,
+                 const YuvToRgbOptions &options)
+{
+    const YuvCoefficients &k =
+        COEFFICIENTS[static_cast<int>(options.matrix)][options.full_range ? 1 : 0];
+    const uint32_t chroma_width = width / 2;
+    const uint32_t chroma_height = height / 2;
+    const size_t luma_size = static_cast<size_t>(width) * height;
+    const bool nv12 = (src_format == FrameFormat::NV12);
+    const bool bilinear = (options.upsampling == ChromaUpsampling::BILINEAR);
+
+    const uint8_t *u_plane = src + luma_size;
+    const uint8_t *v_plane = u_plane + luma_size / 4;
+
+    std::vector<uint8_t> scratch;
+    uint8_t *u_half = nullptr;
+    uint8_t *v_half = nullptr;
+    uint8_t *u_full = nullptr;
+    uint8_t *v_full = nullptr;
+    if (nv12 || bilinear) {
+        scratch.resize(4 * static_cast<size_t>(chroma_width) + 2 * static_cast<size_t>(width));
+        u_half = scratch.data();
+        v_half = u_half + chroma_width;
+        uint8_t *u_next = v_half + chroma_width;
+        uint8_t *v_next = u_next + chroma_width;
+        u_full = v_next + chroma_width;
+        v_full = u_full + width;
+    }
+
+    // Copy one chroma row of either layout into planar u/v
+    auto load_chroma_row = [&](uint32_t row, uint8_t *u_out, uint8_t *v_out) {
+        if (nv12) {
+            const uint8_t *uv = u_plane + static_cast<size_t>(row) * width;
+            for (uint32_t i = 0; i < chroma_width; ++i) {
+                u_out[i] = uv[2 * i];
+                v_out[i] = uv[2 * i + 1];
+            }
+        } else {
+            memcpy(u_out, u_plane + static_cast<size_t>(row) * chroma_width, chroma_width);
+            memcpy(v_out, v_plane + static_cast<size_t>(row) * chroma_width, chroma_width);
+        }
+    };
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t *y_row = src + static_cast<size_t>(y) * width;
+        uint8_t *dst_row = dst + static_cast<size_t>(y) * width * PackedRgbTraits<Dst>::BYTES_PER_PIXEL;
+        uint32_t chroma_row = y / 2;
+
+        if (!bilinear) {
+            if (nv12) {
+                if (y % 2 == 0) {
+                    load_chroma_row(chroma_row, u_half, v_half);
+                }
+                YuvRowKernel<Dst>::template Run<true>(y_row, u_half, v_half, dst_row, width, k);
+            } else {
+                YuvRowKernel<Dst>::template Run<true>(y_row, u_plane + static_cast<size_t>(chroma_row) * chroma_width,
+                                                      v_plane + static_cast<size_t>(chroma_row) * chroma_width,
+                                                      dst_row, width, k);
+            }
+            continue;
+        }
+
+        // Chroma samples sit on even rows and columns, odd ones average their two neighbours
+        load_chroma_row(chroma_row, u_half, v_half);
+        if (y % 2 == 1 && chroma_row + 1 < chroma_height) {
+            uint8_t *u_next = v_half + chroma_width;
+            uint8_t *v_next = u_next + chroma_width;
+            load_chroma_row(chroma_row + 1, u_next, v_next);
+            for (uint32_t i = 0; i < chroma_width; ++i) {
+                u_half[i] = static_cast<uint8_t>((u_half[i] + u_next[i] + 1) >> 1);
+                v_half[i] = static_cast<uint8_t>((v_half[i] + v_next[i] + 1) >> 1);
+            }
+        }
+        for (uint32_t i = 0; i < chroma_width; ++i) {
+            uint32_t next = std::min(i + 1, chroma_width - 1);
+            u_full[2 * i] = u_half[i];
+            v_full[2 * i] = v_half[i];
+            u_full[2 * i + 1] = static_cast<uint8_t>((u_half[i] + u_half[next] + 1) >> 1);
+            v_full[2 * i + 1] = static_cast<uint8_t>((v_half[i] + v_half[next] + 1) >> 1);
+        }
+        YuvRowKernel<Dst>::template Run<false>(y_row, u_full, v_full, dst_row, width, k);
+    }
+}
+
+} // namespace
+
+bool IsYuv420Format(FrameFormat format)
+{
+    return format == FrameFormat::I420 || format == FrameFormat::NV12;
+}
+
+bool ConvertYuv420ToPackedRgb(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                              uint32_t width, uint32_t height, const YuvToRgbOptions &options)
+{
+    if (!src || !dst || !IsYuv420Format(src_format) || width < 2 || height < 2 || (width | height) & 1) {
+        return false;
+    }
+
+    switch (dst_format) {
+        case FrameFormat::RGB24:
+            ConvertRows<FrameFormat::RGB24>(src_format, src, dst, width, height, options);
+            return true;
+        case FrameFormat::BGR24:
+            ConvertRows<FrameFormat::BGR24>(src_format, src, dst, width, height, options);
+            return true;
+        case FrameFormat::RGBA32:
+            ConvertRows<FrameFormat::RGBA32>(src_format, src, dst, width, height, options);
+            return true;
+        case FrameFormat::BGRA32:
+            ConvertRows<FrameFormat::BGRA32>(src_format, src, dst, width, height, options);
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,57 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_YUV_RGB_KERNELS_H
+#define LMSHAO_REMOTE_DESK_YUV_RGB_KERNELS_H
+
+#include <cstdint>
+
+#include "packed_rgb_kernels.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief YCbCr colour matrix
+ */
+enum class YuvMatrix {
+    BT601 = 0, // SD content, what the RGB -> I420 kernels produce
+    BT709 = 1, // HD content, hardware decoders
+    BT2020 = 2,
+};
+
+/**
+ * @brief Chroma upsampling from 4:2:0 to one sample per pixel
+ */
+enum class ChromaUpsampling {
+    NEAREST = 0,  // Each chroma sample covers its 2x2 block
+    BILINEAR = 1, // Interpolated between neighbouring samples, smoother edges on text
+};
+
+/**
+ * @brief YUV -> RGB conversion options
+ */
+struct YuvToRgbOptions {
+    YuvMatrix matrix = YuvMatrix::BT601;
+    bool full_range = false; // JPEG/full range input instead of 16-235 studio range
+    ChromaUpsampling upsampling = ChromaUpsampling::NEAREST;
+};
+
+bool IsYuv420Format(FrameFormat format);
+
+/**
+ * @brief Convert a tightly packed I420 or NV12 image to a packed RGB format
+ * Chroma planes follow the Y plane with a stride of width / 2, as produced
+ * by PixelFormatConverter. Width and height must be even.
+ * @return false for unsupported formats or odd dimensions
+ */
+bool ConvertYuv420ToPackedRgb(FrameFormat src_format, FrameFormat dst_format, const uint8_t *src, uint8_t *dst,
+                              uint32_t width, uint32_t height, const YuvToRgbOptions &options = {});
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_YUV_RGB_KERNELS_H
@@ -0,0 +1,58 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "annexb_parser.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+// Returns the offset of the first byte after a 3-byte start code at or after pos, or size if none
+size_t FindStartCode(const uint8_t *data, size_t size, size_t pos)
+{
+    while (pos + 3 <= size) {
+        if (data[pos + 2] > 1) {
+            pos += 3; // Cannot be part of a start code ending within the next two bytes
+        } else if (data[pos] == 0 && data[pos + 1] == 0 && data[pos + 2] == 1) {
+            return pos + 3;
+        } else {
+            pos++;
+        }
+    }
+    return size;
+}
+
+} // namespace
+
+std::vector<NalUnitView> SplitAnnexB(const uint8_t *data, size_t size)
+{
+    std::vector<NalUnitView> nal_units;
+    if (!data || size == 0) {
+        return nal_units;
+    }
+
+    size_t begin = FindStartCode(data, size, 0);
+    while (begin < size) {
+        size_t next = FindStartCode(data, size, begin);
+        size_t end = next < size ? next - 3 : size;
+
+        // Zero bytes before the next start code are either its 4-byte form or trailing_zero_8bits
+        while (end > begin && data[end - 1] == 0) {
+            end--;
+        }
+
+        if (end > begin) {
+            nal_units.push_back({data + begin, end - begin});
+        }
+        begin = next;
+    }
+
+    return nal_units;
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,34 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_ANNEXB_PARSER_H
+#define LMSHAO_REMOTE_DESK_ANNEXB_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Non-owning view of one NAL unit (without start code)
+ */
+struct NalUnitView {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief Split an Annex-B byte stream (00 00 01 / 00 00 00 01 start codes) into NAL units
+ * Trailing zero bytes belonging to the next start code are stripped.
+ */
+std::vector<NalUnitView> SplitAnnexB(const uint8_t *data, size_t size);
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_ANNEXB_PARSER_H
@@ -0,0 +1,175 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "h265_rtp_packetizer.h"
+
+#include <algorithm>
+
+#include "../core/frame_tracer.h"
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+constexpr size_t NAL_HEADER_SIZE = 2;
+constexpr size_t FU_HEADER_SIZE = 1;
+constexpr size_t AP_LENGTH_FIELD_SIZE = 2;
+
+uint8_t GetForbiddenBit(const NalUnitView &nal)
+{
+    return nal.data[0] & 0x80;
+}
+
+uint8_t GetNalType(const NalUnitView &nal)
+{
+    return (nal.data[0] >> 1) & 0x3F;
+}
+
+uint8_t GetLayerId(const NalUnitView &nal)
+{
+    return static_cast<uint8_t>(((nal.data[0] & 0x01) << 5) | (nal.data[1] >> 3));
+}
+
+uint8_t GetTid(const NalUnitView &nal)
+{
+    return nal.data[1] & 0x07;
+}
+
+// Write a 2-byte payload header: F | Type | LayerId | TID
+void WritePayloadHeader(uint8_t *dst, uint8_t forbidden, uint8_t type, uint8_t layer_id, uint8_t tid)
+{
+    dst[0] = static_cast<uint8_t>(forbidden | (type << 1) | (layer_id >> 5));
+    dst[1] = static_cast<uint8_t>(((layer_id & 0x1F) << 3) | tid);
+}
+
+} // namespace
+
+H265RtpPacketizer::H265RtpPacketizer(size_t max_payload_size, bool enable_aggregation)
+    : max_payload_size_(std::max<size_t>(max_payload_size, NAL_HEADER_SIZE + FU_HEADER_SIZE + 1)),
+      enable_aggregation_(enable_aggregation)
+{
+}
+
+std::vector<RtpPayload> H265RtpPacketizer::Packetize(const uint8_t *data, size_t size) const
+{
+    return Packetize(SplitAnnexB(data, size));
+}
+
+std::vector<RtpPayload> H265RtpPacketizer::Packetize(const std::vector<NalUnitView> &nal_units) const
+{
+    FrameTracer::Span span("H265 packetize", TraceCategory::PACKETIZE);
+    std::vector<RtpPayload> out;
+
+    size_t i = 0;
+    while (i < nal_units.size()) {
+        const NalUnitView &nal = nal_units[i];
+        if (nal.size <= NAL_HEADER_SIZE) {
+            LOG_WARN("Skipping truncated H265 NAL unit of %zu bytes", nal.size);
+            i++;
+            continue;
+        }
+
+        if (nal.size > max_payload_size_) {
+            EmitFragments(nal, out);
+            i++;
+            continue;
+        }
+
+        // Collect following NAL units that fit into one aggregation packet together with this one
+        size_t last = i + 1;
+        if (enable_aggregation_) {
+            size_t ap_size = NAL_HEADER_SIZE + AP_LENGTH_FIELD_SIZE + nal.size;
+            while (last < nal_units.size() && nal_units[last].size > NAL_HEADER_SIZE) {
+                size_t next_size = ap_size + AP_LENGTH_FIELD_SIZE + nal_units[last].size;
+                if (next_size > max_payload_size_) {
+                    break;
+                }
+                ap_size = next_size;
+                last++;
+            }
+        }
+
+        if (last - i >= 2) {
+            EmitAggregation(nal_units, i, last, out);
+        } else {
+            // Single NAL unit packet: the NAL unit header doubles as the payload header
+            RtpPayload payload;
+            payload.data.assign(nal.data, nal.data + nal.size);
+            out.push_back(std::move(payload));
+        }
+        i = last;
+    }
+
+    if (!out.empty()) {
+        out.back().marker = true;
+    }
+    return out;
+}
+
+void H265RtpPacketizer::EmitAggregation(const std::vector<NalUnitView> &nal_units, size_t first, size_t last,
+                                        std::vector<RtpPayload> &out) const
+{
+    // RFC 7798 4.4.2: F is the OR of all F bits, LayerId and TID are the lowest of the aggregated units
+    uint8_t forbidden = 0;
+    uint8_t layer_id = 0x3F;
+    uint8_t tid = 0x07;
+    size_t total = NAL_HEADER_SIZE;
+    for (size_t i = first; i < last; ++i) {
+        forbidden |= GetForbiddenBit(nal_units[i]);
+        layer_id = std::min(layer_id, GetLayerId(nal_units[i]));
+        tid = std::min(tid, GetTid(nal_units[i]));
+        total += AP_LENGTH_FIELD_SIZE + nal_units[i].size;
+    }
+
+    RtpPayload payload;
+    payload.data.resize(total);
+    uint8_t *dst = payload.data.data();
+    WritePayloadHeader(dst, forbidden, NAL_TYPE_AP, layer_id, tid);
+    dst += NAL_HEADER_SIZE;
+
+    for (size_t i = first; i < last; ++i) {
+        const NalUnitView &nal = nal_units[i];
+        dst[0] = static_cast<uint8_t>(nal.size >> 8);
+        dst[1] = static_cast<uint8_t>(nal.size & 0xFF);
+        std::copy(nal.data, nal.data + nal.size, dst + AP_LENGTH_FIELD_SIZE);
+        dst += AP_LENGTH_FIELD_SIZE + nal.size;
+    }
+
+    out.push_back(std::move(payload));
+}
+
+void H265RtpPacketizer::EmitFragments(const NalUnitView &nal, std::vector<RtpPayload> &out) const
+{
+    const uint8_t nal_type = GetNalType(nal);
+    const size_t max_fragment = max_payload_size_ - NAL_HEADER_SIZE - FU_HEADER_SIZE;
+
+    // The NAL unit header is not repeated in fragments, it is rebuilt from the payload and FU headers
+    const uint8_t *src = nal.data + NAL_HEADER_SIZE;
+    size_t remaining = nal.size - NAL_HEADER_SIZE;
+    bool first = true;
+
+    while (remaining > 0) {
+        size_t fragment = std::min(remaining, max_fragment);
+        bool last = (fragment == remaining);
+
+        RtpPayload payload;
+        payload.data.resize(NAL_HEADER_SIZE + FU_HEADER_SIZE + fragment);
+        uint8_t *dst = payload.data.data();
+        WritePayloadHeader(dst, GetForbiddenBit(nal), NAL_TYPE_FU, GetLayerId(nal), GetTid(nal));
+        dst[2] = static_cast<uint8_t>((first ? 0x80 : 0x00) | (last ? 0x40 : 0x00) | nal_type);
+        std::copy(src, src + fragment, dst + NAL_HEADER_SIZE + FU_HEADER_SIZE);
+        out.push_back(std::move(payload));
+
+        src += fragment;
+        remaining -= fragment;
+        first = false;
+    }
+}
+
+} // namespace lmshao::remotedesk
@@ -0,0 +1,78 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_H265_RTP_PACKETIZER_H
+#define LMSHAO_REMOTE_DESK_H265_RTP_PACKETIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "annexb_parser.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief RTP payload produced by a packetizer (RTP header is added by the sender)
+ */
+struct RtpPayload {
+    std::vector<uint8_t> data;
+    bool marker = false; // Last packet of the access unit
+};
+
+/**
+ * @brief H265 RTP packetizer (RFC 7798)
+ * Emits single NAL unit packets, aggregation packets (AP, type 48) for runs
+ * of small NAL units such as VPS/SPS/PPS/SEI, and fragmentation units
+ * (FU, type 49) for NAL units larger than the payload budget. DONL fields
+ * are never emitted (sprop-max-don-diff = 0).
+ * Not wired into a sender yet; an RTP sink for H265 output is expected to
+ * feed it the access units produced by VideoEncoder.
+ */
+class H265RtpPacketizer {
+public:
+    static constexpr uint8_t NAL_TYPE_AP = 48;
+    static constexpr uint8_t NAL_TYPE_FU = 49;
+
+    /**
+     * @param max_payload_size Largest RTP payload in bytes (MTU minus IP/UDP/RTP headers)
+     * @param enable_aggregation Pack consecutive small NAL units into AP packets
+     */
+    explicit H265RtpPacketizer(size_t max_payload_size = 1200, bool enable_aggregation = true);
+
+    /**
+     * @brief Packetize one Annex-B access unit
+     */
+    std::vector<RtpPayload> Packetize(const uint8_t *data, size_t size) const;
+
+    /**
+     * @brief Packetize NAL units already split from an access unit
+     */
+    std::vector<RtpPayload> Packetize(const std::vector<NalUnitView> &nal_units) const;
+
+    size_t GetMaxPayloadSize() const { return max_payload_size_; }
+
+private:
+    /**
+     * @brief Emit an aggregation packet for nal_units[first, last)
+     */
+    void EmitAggregation(const std::vector<NalUnitView> &nal_units, size_t first, size_t last,
+                         std::vector<RtpPayload> &out) const;
+
+    /**
+     * @brief Emit fragmentation units for a NAL unit that does not fit in one packet
+     */
+    void EmitFragments(const NalUnitView &nal, std::vector<RtpPayload> &out) const;
+
+private:
+    size_t max_payload_size_;
+    bool enable_aggregation_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // LMSHAO_REMOTE_DESK_H265_RTP_PACKETIZER_H
@@ -0,0 +1,238 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifdef __linux__
+
+#include "shm_frame_sink.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "../core/frame_tracer.h"
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+constexpr size_t DEFAULT_SLOT_SIZE = 3840 * 2160 * 4;
+constexpr int ACCEPT_POLL_TIMEOUT_MS = 200;
+
+} // namespace
+
+ShmFrameSink::ShmFrameSink(const ShmFrameSinkConfig &config) : config_(config)
+{
+    if (config_.slot_size == 0) {
+        config_.slot_size = DEFAULT_SLOT_SIZE;
+    }
+}
+
+ShmFrameSink::~ShmFrameSink()
+{
+    Stop();
+}
+
+bool ShmFrameSink::Initialize()
+{
+    if (running_) {
+        LOG_ERROR("Cannot initialize while the shared frame sink is running");
+        return false;
+    }
+    if (config_.socket_path.empty()) {
+        LOG_ERROR("Shared frame sink needs a socket path");
+        return false;
+    }
+
+    ring_ = ShmFrameRing::Create(config_.slot_count, config_.slot_size);
+    if (ring_ && config_.lock_memory) {
+        ring_->LockMemory();
+    }
+    return ring_ != nullptr;
+}
+
+bool ShmFrameSink::Start()
+{
+    if (running_) {
+        return true;
+    }
+    if (!ring_ && !Initialize()) {
+        return false;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (config_.socket_path.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Socket path too long: %s", config_.socket_path.c_str());
+        return false;
+    }
+    strncpy(addr.sun_path, config_.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        LOG_ERROR("Failed to create Unix socket: %s", strerror(errno));
+        return false;
+    }
+
+    unlink(config_.socket_path.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 1) != 0) {
+        LOG_ERROR("Failed to listen on %s: %s", config_.socket_path.c_str(), strerror(errno));
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    if (config_.socket_mode != 0 && chmod(config_.socket_path.c_str(), config_.socket_mode) != 0) {
+        LOG_WARN("Failed to chmod %s: %s", config_.socket_path.c_str(), strerror(errno));
+    }
+
+    running_ = true;
+    accept_thread_ = std::thread(&ShmFrameSink::AcceptThreadProc, this);
+
+    LOG_DEBUG("Shared frame sink listening on %s", config_.socket_path.c_str());
+    return true;
+}
+
+void ShmFrameSink::Stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+
+    CloseConsumer();
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(config_.socket_path.c_str());
+
+    LOG_DEBUG("Shared frame sink stopped");
+}
+
+void ShmFrameSink::AcceptThreadProc()
+{
+    while (running_) {
+        // Watch the listening socket for a new consumer and the current one for hangup
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {consumer_fd_.load(), POLLIN, 0}};
+        nfds_t count = fds[1].fd >= 0 ? 2 : 1;
+        if (poll(fds, count, ACCEPT_POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+
+        if (count == 2 && (fds[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+            // Consumers never send after the handshake, readable means closed
+            LOG_INFO("Shared frame consumer disconnected");
+            CloseConsumer();
+        }
+
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        if (consumer_fd_ >= 0) {
+            LOG_WARN("Rejecting second shared frame consumer, the ring has a single reader");
+            close(fd);
+            continue;
+        }
+        if (!ShmFrameRing::SendDescriptors(fd, ring_->GetMemoryFd(), ring_->GetEventFd())) {
+            close(fd);
+            continue;
+        }
+
+        consumer_fd_ = fd;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.consumers_connected++;
+        LOG_INFO("Shared frame consumer connected on %s", config_.socket_path.c_str());
+    }
+}
+
+void ShmFrameSink::CloseConsumer()
+{
+    int fd = consumer_fd_.exchange(-1);
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+ShmFrameSlotView ShmFrameSink::AcquireSlot()
+{
+    if (!running_ || consumer_fd_ < 0) {
+        next_sequence_++;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_dropped++;
+        return {};
+    }
+
+    write_mutex_.lock();
+    // Numbered under the lock so published slots stay in order
+    uint64_t sequence = next_sequence_++;
+    ShmFrameSlotView slot = ring_->AcquireWriteSlot();
+    if (!slot) {
+        write_mutex_.unlock();
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_dropped++;
+        return slot;
+    }
+    // On success write_mutex_ stays held until CommitSlot
+    slot_sequence_ = sequence;
+    return slot;
+}
+
+void ShmFrameSink::CommitSlot()
+{
+    ring_->CommitWriteSlot(slot_sequence_);
+    write_mutex_.unlock();
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.frames_written++;
+}
+
+void ShmFrameSink::OnFrame(const std::shared_ptr<Frame> &frame)
+{
+    if (!frame || !frame->IsValid()) {
+        return;
+    }
+
+    if (frame->Size() > config_.slot_size) {
+        LOG_WARN("Frame of %zu bytes does not fit a %zu byte shared slot", frame->Size(), config_.slot_size);
+        next_sequence_++;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames_oversized++;
+        return;
+    }
+
+    FrameTracer::Span span("shm ring write", TraceCategory::SEND, frame->timestamp);
+    ShmFrameSlotView slot = AcquireSlot();
+    if (!slot) {
+        return;
+    }
+
+    slot.SetMeta(*frame);
+    memcpy(slot.data, frame->Data(), frame->Size());
+    CommitSlot();
+}
+
+ShmFrameSink::TransportStats ShmFrameSink::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
@@ -0,0 +1,106 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_SHM_FRAME_SINK_H
+#define LMSHAO_REMOTE_DESK_SHM_FRAME_SINK_H
+
+#ifdef __linux__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../core/media_sink.h"
+#include "../core/shm_frame_ring.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Shared memory frame sink configuration
+ */
+struct ShmFrameSinkConfig {
+    std::string socket_path;  // Unix domain socket the consumer process connects to
+    uint32_t slot_count = 4;  // Frames in flight between the processes
+    size_t slot_size = 0;     // Largest frame in bytes (0 = 3840x2160 BGRA)
+    uint32_t socket_mode = 0; // chmod() of the socket so another user can connect (0 = leave umask default)
+    bool lock_memory = false; // mlock the ring, see ShmFrameRing::LockMemory()
+};
+
+/**
+ * @brief Producer end of a cross-process frame transport
+ * Owns a ShmFrameRing and publishes it on a Unix domain socket: a consumer
+ * (ShmFrameSource in another process, typically the sandboxed encoder) that
+ * connects receives the memfd and eventfd and maps the same slots. Frames
+ * passed to OnFrame are copied into the next free slot; a producer that can
+ * render straight into shared memory uses AcquireSlot/CommitSlot instead.
+ * Frames are dropped, never queued, while the consumer is behind or not
+ * connected. Every frame offered is numbered, dropped ones included, so the
+ * consumer sees each drop as a sequence gap.
+ */
+class ShmFrameSink : public MediaSink {
+public:
+    explicit ShmFrameSink(const ShmFrameSinkConfig &config);
+    ~ShmFrameSink() override;
+
+    // MediaSink interface implementation
+    bool Initialize() override;
+    bool Start() override;
+    void Stop() override;
+    bool IsRunning() const override { return running_; }
+    void OnFrame(const std::shared_ptr<Frame> &frame) override;
+
+    bool HasConsumer() const { return consumer_fd_ >= 0; }
+
+    /**
+     * @brief Reserve the next slot for a frame written in place
+     * Holds the write lock until CommitSlot on success; the caller writes the
+     * metadata (ShmFrameSlotView::SetMeta) and at most capacity bytes of data.
+     * @return Empty view if the ring is full, no consumer is attached or the sink is stopped
+     */
+    ShmFrameSlotView AcquireSlot();
+
+    /**
+     * @brief Publish the slot reserved by AcquireSlot once its data and metadata are written
+     */
+    void CommitSlot();
+
+    struct TransportStats {
+        uint64_t frames_written = 0;
+        uint64_t frames_dropped = 0;   // Ring full or no consumer
+        uint64_t frames_oversized = 0; // Larger than slot_size
+        uint64_t consumers_connected = 0;
+    };
+    TransportStats GetStats() const;
+
+private:
+    void AcceptThreadProc();
+    void CloseConsumer();
+
+private:
+    ShmFrameSinkConfig config_;
+    std::unique_ptr<ShmFrameRing> ring_;
+    std::mutex write_mutex_; // Serializes producers on the single-producer ring
+    std::atomic<uint64_t> next_sequence_{1};
+    uint64_t slot_sequence_ = 0; // Number of the slot reserved by AcquireSlot, under write_mutex_
+
+    int listen_fd_ = -1;
+    std::atomic<int> consumer_fd_{-1};
+    std::atomic<bool> running_{false};
+    std::thread accept_thread_;
+
+    mutable std::mutex stats_mutex_;
+    TransportStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
+
+#endif // LMSHAO_REMOTE_DESK_SHM_FRAME_SINK_H
@@ -0,0 +1,256 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifdef __linux__
+
+#include "shm_frame_source.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "../log/remote_desk_log.h"
+
+namespace lmshao::remotedesk {
+
+namespace {
+
+constexpr int READ_POLL_TIMEOUT_MS = 200;
+
+/**
+ * @brief Check that the metadata describes a frame that fits the slot
+ */
+bool IsValidMeta(const ShmFrameMeta &meta, size_t capacity)
+{
+    if (meta.size == 0 || meta.size > capacity) {
+        return false;
+    }
+
+    FrameFormat format = static_cast<FrameFormat>(meta.format);
+    FrameFormat type = GetFrameType(format);
+    if (type == FrameFormat::AUDIO_BASE) {
+        return true;
+    }
+    if (type != FrameFormat::VIDEO_BASE || meta.width == 0 || meta.height == 0) {
+        return false;
+    }
+
+    uint64_t pixels = static_cast<uint64_t>(meta.width) * meta.height;
+    uint32_t bytes_per_pixel = 0;
+    switch (format) {
+        case FrameFormat::I420:
+        case FrameFormat::NV12:
+            return pixels * 3 / 2 <= meta.size;
+        case FrameFormat::I444:
+        case FrameFormat::I010: // 4:2:0 in 16-bit samples
+            return pixels * 3 <= meta.size;
+        case FrameFormat::RGB24:
+        case FrameFormat::BGR24:
+            bytes_per_pixel = 3;
+            break;
+        case FrameFormat::RGBA32:
+        case FrameFormat::BGRA32:
+        case FrameFormat::X2RGB10:
+            bytes_per_pixel = 4;
+            break;
+        default:
+            return true; // Encoded: only the size is known
+    }
+    return meta.stride >= static_cast<uint64_t>(meta.width) * bytes_per_pixel &&
+           static_cast<uint64_t>(meta.stride) * meta.height <= meta.size;
+}
+
+} // namespace
+
+ShmFrameSource::ShmFrameSource(const ShmFrameSourceConfig &config) : config_(config) {}
+
+ShmFrameSource::~ShmFrameSource()
+{
+    Stop();
+}
+
+bool ShmFrameSource::Initialize()
+{
+    if (config_.socket_path.empty()) {
+        LOG_ERROR("Shared frame source needs a socket path");
+        return false;
+    }
+    if (config_.socket_path.size() >= sizeof(sockaddr_un::sun_path)) {
+        LOG_ERROR("Socket path too long: %s", config_.socket_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ShmFrameSource::Start()
+{
+    if (running_) {
+        return true;
+    }
+    if (!Initialize()) {
+        return false;
+    }
+
+    running_ = true;
+    reader_thread_ = std::thread(&ShmFrameSource::ReaderThreadProc, this);
+    LOG_DEBUG("Shared frame source started on %s", config_.socket_path.c_str());
+    return true;
+}
+
+void ShmFrameSource::Stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (reader_thread_.joinable()) {
+        reader_thread_.join();
+    }
+    LOG_DEBUG("Shared frame source stopped");
+}
+
+void ShmFrameSource::SetSlotHandler(SlotHandler handler)
+{
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    slot_handler_ = std::move(handler);
+}
+
+int ShmFrameSource::Connect()
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create Unix socket: %s", strerror(errno));
+        return -1;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, config_.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void ShmFrameSource::ReaderThreadProc()
+{
+    bool first_connection = true;
+
+    while (running_) {
+        int socket_fd = Connect();
+        if (socket_fd < 0) {
+            std::this_thread::sleep_for(config_.reconnect_interval);
+            continue;
+        }
+
+        int memory_fd = -1;
+        int event_fd = -1;
+        std::unique_ptr<ShmFrameRing> ring;
+        if (ShmFrameRing::ReceiveDescriptors(socket_fd, memory_fd, event_fd)) {
+            ring = ShmFrameRing::Attach(memory_fd, event_fd);
+        }
+        if (!ring) {
+            close(socket_fd);
+            std::this_thread::sleep_for(config_.reconnect_interval);
+            continue;
+        }
+
+        if (config_.lock_memory) {
+            ring->LockMemory();
+        }
+
+        // Frames published before this reader attached are stale
+        ring->Resync();
+        next_sequence_ = 0;
+        connected_ = true;
+        if (!first_connection) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.reconnects++;
+        }
+        first_connection = false;
+        LOG_INFO("Attached to shared frame ring on %s", config_.socket_path.c_str());
+
+        while (running_) {
+            pollfd fds[2] = {{ring->GetEventFd(), POLLIN, 0}, {socket_fd, POLLIN, 0}};
+            int ready = poll(fds, 2, READ_POLL_TIMEOUT_MS);
+            if (ready < 0 && errno != EINTR) {
+                LOG_ERROR("poll on shared frame ring failed: %s", strerror(errno));
+                break;
+            }
+            if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+                LOG_INFO("Shared frame producer went away");
+                break;
+            }
+            if (fds[0].revents & POLLIN) {
+                ring->ConsumeNotification();
+                DrainRing(*ring);
+            }
+        }
+
+        connected_ = false;
+        ring.reset();
+        close(socket_fd);
+    }
+}
+
+void ShmFrameSource::DrainRing(ShmFrameRing &ring)
+{
+    for (ShmFrameSlotView slot = ring.PeekReadSlot(); slot; slot = ring.PeekReadSlot()) {
+        // The producer may rewrite the slot meanwhile: validate a copy and use only that
+        ShmFrameMeta meta = slot.ReadMeta();
+        bool valid = IsValidMeta(meta, slot.capacity);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.frames_received++;
+            if (next_sequence_ != 0 && meta.sequence > next_sequence_) {
+                stats_.frames_lost += meta.sequence - next_sequence_;
+            }
+            if (!valid) {
+                stats_.frames_invalid++;
+            }
+        }
+        next_sequence_ = meta.sequence + 1;
+
+        if (!valid) {
+            LOG_WARN("Dropping shared frame %llu with invalid metadata",
+                     static_cast<unsigned long long>(meta.sequence));
+            ring.ReleaseReadSlot();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> handler_lock(handler_mutex_);
+        if (slot_handler_) {
+            slot_handler_(meta, slot.data);
+        } else {
+            handler_lock.unlock();
+            size_t size = static_cast<size_t>(meta.size);
+            auto frame = std::make_shared<Frame>(size);
+            frame->SetSize(size);
+            meta.CopyTo(*frame);
+            memcpy(frame->data(), slot.data, size);
+            DeliverFrame(frame);
+        }
+
+        ring.ReleaseReadSlot();
+    }
+}
+
+ShmFrameSource::TransportStats ShmFrameSource::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
@@ -0,0 +1,108 @@
+/**
+ * @author SHAO Liming <lmshao@163.com>
+ * @copyright Copyright (c) 2025 SHAO Liming
+ * @license MIT
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LMSHAO_REMOTE_DESK_SHM_FRAME_SOURCE_H
+#define LMSHAO_REMOTE_DESK_SHM_FRAME_SOURCE_H
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../core/media_source.h"
+#include "../core/shm_frame_ring.h"
+
+namespace lmshao::remotedesk {
+
+/**
+ * @brief Shared memory frame source configuration
+ */
+struct ShmFrameSourceConfig {
+    std::string socket_path; // Socket published by the producer's ShmFrameSink
+    std::chrono::milliseconds reconnect_interval{200};
+    bool lock_memory = false; // mlock the ring once attached, see ShmFrameRing::LockMemory()
+};
+
+/**
+ * @brief Consumer end of a cross-process frame transport
+ * Connects to a ShmFrameSink, maps the ring it hands over and reads frames
+ * as the producer publishes them. Each slot is copied into a Frame and
+ * delivered to the sinks of this source, or handed in place to the slot
+ * handler when one is set. The producer is not trusted, slots with
+ * inconsistent metadata are dropped. The source reconnects when the producer
+ * restarts.
+ */
+class ShmFrameSource : public MediaSource {
+public:
+    explicit ShmFrameSource(const ShmFrameSourceConfig &config);
+    ~ShmFrameSource() override;
+
+    // MediaSource interface implementation
+    bool Initialize() override;
+    bool Start() override;
+    void Stop() override;
+    bool IsRunning() const override { return running_; }
+
+    bool IsConnected() const { return connected_; }
+
+    /**
+     * @brief Read slots in place instead of copying them into Frames
+     * The handler runs on the reader thread with the validated metadata copy and
+     * the slot data (meta.size bytes), which stay valid until it returns. The
+     * producer may rewrite the pixels meanwhile, never the metadata passed in.
+     * An empty handler restores delivery to the sinks.
+     */
+    using SlotHandler = std::function<void(const ShmFrameMeta &meta, const uint8_t *data)>;
+    void SetSlotHandler(SlotHandler handler);
+
+    struct TransportStats {
+        uint64_t frames_received = 0;
+        uint64_t frames_lost = 0;    // Sequence gaps: frames the producer dropped since this side attached
+        uint64_t frames_invalid = 0; // Metadata inconsistent with the slot, dropped
+        uint64_t reconnects = 0;
+    };
+    TransportStats GetStats() const;
+
+private:
+    void ReaderThreadProc();
+
+    /**
+     * @brief Connect and receive the ring, returns the connected socket or -1
+     */
+    int Connect();
+
+    /**
+     * @brief Deliver every published slot to the sinks
+     */
+    void DrainRing(ShmFrameRing &ring);
+
+private:
+    ShmFrameSourceConfig config_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::thread reader_thread_;
+
+    uint64_t next_sequence_ = 0;
+
+    std::mutex handler_mutex_;
+    SlotHandler slot_handler_;
+
+    mutable std::mutex stats_mutex_;
+    TransportStats stats_;
+};
+
+} // namespace lmshao::remotedesk
+
+#endif // __linux__
+
+#endif // LMSHAO_REMOTE_DESK_SHM_FRAME_SOURCE_H